@@ -68,6 +68,7 @@ fast_downward_plugin(
         pruning_method
         search_engine
         search_node_info
+        search_profiler
         search_progress
         search_space
         search_statistics
@@ -128,6 +129,7 @@ fast_downward_plugin(
         utils/system
         utils/system_unix
         utils/system_windows
+        utils/thread_pool
         utils/timer
     CORE_PLUGIN
 )
@@ -551,7 +553,7 @@ fast_downward_plugin(
     HELP "The h^m heuristic"
     SOURCES
         heuristics/hm_heuristic
-    DEPENDS TASK_PROPERTIES
+    DEPENDS FACT_TUPLE_RANKING TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -601,6 +603,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME FACT_TUPLE_RANKING
+    HELP "Ranking of tuples of facts"
+    SOURCES
+        task_utils/fact_tuple_ranking
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME SAMPLING
     HELP "Sampling"
@@ -653,6 +663,7 @@ fast_downward_plugin(
         cegar/split_selector
         cegar/subtask_generators
         cegar/transition
+        cegar/transition_lists
         cegar/transition_system
         cegar/types
         cegar/utils
@@ -724,7 +735,7 @@ fast_downward_plugin(
         landmarks/landmark_status_manager
         landmarks/landmark_sum_heuristic
         landmarks/util
-    DEPENDS LP_SOLVER PRIORITY_QUEUES SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS FACT_TUPLE_RANKING LP_SOLVER PRIORITY_QUEUES SUCCESSOR_GENERATOR TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -748,9 +759,9 @@ fast_downward_plugin(
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
         pdbs/cegar
+        pdbs/decision_diagram
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
-        pdbs/match_tree
         pdbs/max_cliques
         pdbs/pattern_cliques
         pdbs/pattern_collection_information
@@ -771,9 +782,12 @@ fast_downward_plugin(
         pdbs/pattern_generator_random
         pdbs/pattern_generator
         pdbs/pattern_information
+        pdbs/pdb_cache
         pdbs/pdb_heuristic
         pdbs/random_pattern
+        pdbs/regression_operator_index
         pdbs/subcategory
+        pdbs/symbolic_pdb_factory
         pdbs/types
         pdbs/utils
         pdbs/validation
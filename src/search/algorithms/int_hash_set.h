@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -108,6 +109,16 @@ class IntHashSet {
     int num_entries;
     int num_resizes;
 
+    /*
+      Probe statistics of the public insert methods: the probe length of
+      a key is the distance of its bucket from its ideal bucket. They are
+      only collected after calling enable_probe_statistics().
+    */
+    bool collect_probe_statistics;
+    int max_probe_length;
+    int64_t num_insert_calls;
+    int64_t total_probe_length;
+
     int capacity() const {
         return buckets.size();
     }
@@ -191,6 +202,18 @@ class IntHashSet {
         return Bucket::empty_bucket_key;
     }
 
+    // Return the distance of the bucket containing the key from its ideal bucket.
+    int get_probe_length(KeyType key, HashType hash) const {
+        int ideal_index = get_bucket(hash);
+        for (int i = 0; i < MAX_DISTANCE; ++i) {
+            const Bucket &bucket = buckets[get_bucket(ideal_index + i)];
+            if (bucket.key == key) {
+                return i;
+            }
+        }
+        ABORT("Key is not contained in the hash set.");
+    }
+
     /*
       Private method that inserts a key and its corresponding hash into the
       hash set.
@@ -267,13 +290,24 @@ class IntHashSet {
         return std::make_pair(key, true);
     }
 
+    void update_probe_statistics(KeyType key, HashType hash) {
+        int probe_length = get_probe_length(key, hash);
+        ++num_insert_calls;
+        total_probe_length += probe_length;
+        max_probe_length = std::max(max_probe_length, probe_length);
+    }
+
 public:
     IntHashSet(const Hasher &hasher, const Equal &equal)
         : hasher(hasher),
           equal(equal),
           buckets(1),
           num_entries(0),
-          num_resizes(0) {
+          num_resizes(0),
+          collect_probe_statistics(false),
+          max_probe_length(0),
+          num_insert_calls(0),
+          total_probe_length(0) {
     }
 
     int size() const {
@@ -289,7 +323,58 @@ public:
     */
     std::pair<KeyType, bool> insert(KeyType key) {
         assert(key >= 0);
-        return insert(key, hasher(key));
+        HashType hash = hasher(key);
+        std::pair<KeyType, bool> result = insert(key, hash);
+        if (collect_probe_statistics) {
+            update_probe_statistics(result.first, hash);
+        }
+        return result;
+    }
+
+    /*
+      Like insert(key), but uses a hash value that the caller has already
+      computed (e.g., to prefetch the bucket with prefetch_bucket()).
+      The hash must be equal to the hash the hasher computes for the key.
+    */
+    std::pair<KeyType, bool> insert_with_hash(KeyType key, HashType hash) {
+        assert(key >= 0);
+        std::pair<KeyType, bool> result = insert(key, hash);
+        if (collect_probe_statistics) {
+            update_probe_statistics(result.first, hash);
+        }
+        return result;
+    }
+
+    /*
+      Prefetch the ideal bucket of the given hash value. This allows
+      overlapping the cache misses of several upcoming lookups.
+    */
+    void prefetch_bucket(HashType hash) const {
+        utils::prefetch(&buckets[get_bucket(hash)]);
+    }
+
+    void enable_probe_statistics() {
+        collect_probe_statistics = true;
+    }
+
+    int get_capacity() const {
+        return capacity();
+    }
+
+    int get_num_resizes() const {
+        return num_resizes;
+    }
+
+    int64_t get_num_insert_calls() const {
+        return num_insert_calls;
+    }
+
+    int64_t get_total_probe_length() const {
+        return total_probe_length;
+    }
+
+    int get_max_probe_length() const {
+        return max_probe_length;
     }
 
     void dump(utils::LogProxy &log) const {
@@ -42,6 +42,19 @@ public:
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Low-level access to the packing layout, for callers that want to
+      combine several writes to the same bin into one masked write:
+      set(buffer, var, value) is equivalent to
+        buffer[b] = (buffer[b] & ~get_read_mask(var)) | get_value_bits(var, value)
+      with b = get_bin_index(var), and get(buffer, var) is equivalent to
+        (buffer[b] & get_read_mask(var)) >> get_shift(var).
+    */
+    int get_bin_index(int var) const;
+    int get_shift(int var) const;
+    Bin get_read_mask(int var) const;
+    Bin get_value_bits(int var, int value) const;
+
     int get_num_bins() const {return num_bins;}
 };
 }
@@ -12,19 +12,40 @@ using namespace std;
 
 namespace cegar {
 AbstractSearch::AbstractSearch(
-    const vector<int> &operator_costs)
+    const vector<int> &operator_costs, SearchStrategy search_strategy)
     : operator_costs(operator_costs),
-      search_info(1) {
+      search_strategy(search_strategy),
+      num_open_entries(0),
+      search_info(1),
+      has_search_tree(false) {
 }
 
 void AbstractSearch::reset(int num_states) {
     open_queue.clear();
+    num_open_entries = 0;
     search_info.resize(num_states);
     for (AbstractSearchInfo &info : search_info) {
         info.reset();
     }
 }
 
+void AbstractSearch::push_to_open_list(int f, int state_id) {
+    open_queue.push(f, state_id);
+    ++num_open_entries;
+}
+
+void AbstractSearch::rebuild_open_list() {
+    open_queue.clear();
+    num_open_entries = 0;
+    for (size_t state_id = 0; state_id < search_info.size(); ++state_id) {
+        const AbstractSearchInfo &info = search_info[state_id];
+        if (info.get_g_value() != INF && info.get_h_value() != INF &&
+            !info.is_expanded()) {
+            push_to_open_list(info.get_g_value() + info.get_h_value(), state_id);
+        }
+    }
+}
+
 unique_ptr<Solution> AbstractSearch::extract_solution(int init_id, int goal_id) const {
     unique_ptr<Solution> solution = utils::make_unique_ptr<Solution>();
     int current_id = goal_id;
@@ -73,17 +94,112 @@ void AbstractSearch::update_goal_distances(const Solution &solution) {
     }
 }
 
+bool AbstractSearch::repair_search_tree(
+    const TransitionLists &outgoing_transitions,
+    const TransitionLists &incoming_transitions, int init_id) {
+    if (!has_search_tree) {
+        return false;
+    }
+    int num_states = search_info.size();
+    assert(incoming_transitions.get_num_states() == num_states);
+    is_invalid.resize(num_states, false);
+
+    /*
+      A state is invalid if it has been split or if its parent in the
+      search tree is invalid. A child of a split state v is the target of
+      a transition from v1 or v2 and its parent is still given by the ID
+      of v, which v1 reuses. Therefore, we can collect all invalid states
+      by following the outgoing transitions from the split states.
+    */
+    vector<int> invalid_state_ids;
+    for (int state_id : split_state_ids) {
+        if (!is_invalid[state_id]) {
+            is_invalid[state_id] = true;
+            invalid_state_ids.push_back(state_id);
+        }
+    }
+    split_state_ids.clear();
+    for (size_t i = 0; i < invalid_state_ids.size(); ++i) {
+        int state_id = invalid_state_ids[i];
+        outgoing_transitions.for_each(
+            state_id, [&](int, int succ_id) {
+                const AbstractSearchInfo &succ_info = search_info[succ_id];
+                if (!is_invalid[succ_id] && succ_info.has_incoming_transition() &&
+                    is_invalid[succ_info.get_incoming_transition().target_id]) {
+                    is_invalid[succ_id] = true;
+                    invalid_state_ids.push_back(succ_id);
+                }
+            });
+    }
+    for (int state_id : invalid_state_ids) {
+        search_info[state_id].reset();
+    }
+    // The initial state changes if it is split.
+    if (is_invalid[init_id]) {
+        search_info[init_id].decrease_g_value_to(0);
+    }
+
+    /*
+      Recompute the g values of invalid states from valid expanded
+      predecessors. Unreached states cannot have expanded predecessors
+      (except via operators with infinite cost). All other reached but
+      unexpanded states are still in the open list.
+    */
+    for (int state_id : invalid_state_ids) {
+        AbstractSearchInfo &info = search_info[state_id];
+        incoming_transitions.for_each(
+            state_id, [&](int op_id, int pred_id) {
+                const AbstractSearchInfo &pred_info = search_info[pred_id];
+                if (!is_invalid[pred_id] && pred_info.is_expanded()) {
+                    int op_cost = operator_costs[op_id];
+                    int g = (op_cost == INF) ? INF : pred_info.get_g_value() + op_cost;
+                    if (g < info.get_g_value()) {
+                        info.decrease_g_value_to(g);
+                        info.set_incoming_transition(Transition(op_id, pred_id));
+                    }
+                }
+            });
+    }
+    for (int state_id : invalid_state_ids) {
+        const AbstractSearchInfo &info = search_info[state_id];
+        if (info.get_g_value() != INF && info.get_h_value() != INF) {
+            push_to_open_list(info.get_g_value() + info.get_h_value(), state_id);
+        }
+        is_invalid[state_id] = false;
+    }
+
+    /*
+      The open list keeps the entries of states that have been reset or
+      expanded since or whose h value increased. At most num_states
+      entries are live, so with more than twice as many entries, stale
+      entries outnumber live ones and we rebuild the open list.
+    */
+    if (num_open_entries > 2 * num_states) {
+        rebuild_open_list();
+    }
+    return true;
+}
+
 unique_ptr<Solution> AbstractSearch::find_solution(
-    const vector<Transitions> &transitions,
+    const TransitionLists &outgoing_transitions,
+    const TransitionLists &incoming_transitions,
     int init_id,
     const Goals &goal_ids) {
-    reset(transitions.size());
-    search_info[init_id].decrease_g_value_to(0);
-    open_queue.push(search_info[init_id].get_h_value(), init_id);
-    int goal_id = astar_search(transitions, goal_ids);
-    open_queue.clear();
+    if (search_strategy == SearchStrategy::ASTAR ||
+        !repair_search_tree(outgoing_transitions, incoming_transitions, init_id)) {
+        reset(outgoing_transitions.get_num_states());
+        search_info[init_id].decrease_g_value_to(0);
+        push_to_open_list(search_info[init_id].get_h_value(), init_id);
+    }
+    int goal_id = astar_search(outgoing_transitions, goal_ids);
+    has_search_tree = true;
     bool has_found_solution = (goal_id != UNDEFINED);
     if (has_found_solution) {
+        if (search_strategy == SearchStrategy::INCREMENTAL) {
+            // The goal state has not been expanded, so it stays open.
+            const AbstractSearchInfo &goal_info = search_info[goal_id];
+            push_to_open_list(goal_info.get_g_value() + goal_info.get_h_value(), goal_id);
+        }
         unique_ptr<Solution> solution = extract_solution(init_id, goal_id);
         update_goal_distances(*solution);
         return solution;
@@ -94,44 +210,57 @@ unique_ptr<Solution> AbstractSearch::find_solution(
 }
 
 int AbstractSearch::astar_search(
-    const vector<Transitions> &transitions, const Goals &goals) {
+    const TransitionLists &transitions, const Goals &goals) {
     while (!open_queue.empty()) {
         pair<int, int> top_pair = open_queue.pop();
+        --num_open_entries;
         int old_f = top_pair.first;
         int state_id = top_pair.second;
 
-        const int g = search_info[state_id].get_g_value();
-        assert(0 <= g && g < INF);
-        int new_f = g + search_info[state_id].get_h_value();
-        assert(new_f <= old_f);
+        const AbstractSearchInfo &info = search_info[state_id];
+        const int g = info.get_g_value();
+        const int h = info.get_h_value();
+        /*
+          Without repairing the search tree, all entries have g < INF, are
+          never expanded and h does not change during the search. Otherwise,
+          the entry may belong to a state that has been reset or expanded
+          since, or the h value may have increased after the last search.
+        */
+        if (g == INF || h == INF || info.is_expanded())
+            continue;
+        assert(g >= 0);
+        int new_f = g + h;
         if (new_f < old_f)
             continue;
+        if (new_f > old_f) {
+            assert(search_strategy == SearchStrategy::INCREMENTAL);
+            push_to_open_list(new_f, state_id);
+            continue;
+        }
         if (goals.count(state_id)) {
             return state_id;
         }
-        assert(utils::in_bounds(state_id, transitions));
-        for (const Transition &transition : transitions[state_id]) {
-            int op_id = transition.op_id;
-            int succ_id = transition.target_id;
-
-            assert(utils::in_bounds(op_id, operator_costs));
-            const int op_cost = operator_costs[op_id];
-            assert(op_cost >= 0);
-            int succ_g = (op_cost == INF) ? INF : g + op_cost;
-            assert(succ_g >= 0);
-
-            if (succ_g < search_info[succ_id].get_g_value()) {
-                search_info[succ_id].decrease_g_value_to(succ_g);
-                int h = search_info[succ_id].get_h_value();
-                if (h == INF)
-                    continue;
-                int f = succ_g + h;
-                assert(f >= 0);
-                assert(f != INF);
-                open_queue.push(f, succ_id);
-                search_info[succ_id].set_incoming_transition(Transition(op_id, state_id));
-            }
-        }
+        search_info[state_id].mark_as_expanded();
+        transitions.for_each(
+            state_id, [&](int op_id, int succ_id) {
+                assert(utils::in_bounds(op_id, operator_costs));
+                const int op_cost = operator_costs[op_id];
+                assert(op_cost >= 0);
+                int succ_g = (op_cost == INF) ? INF : g + op_cost;
+                assert(succ_g >= 0);
+
+                if (succ_g < search_info[succ_id].get_g_value()) {
+                    search_info[succ_id].decrease_g_value_to(succ_g);
+                    int h = search_info[succ_id].get_h_value();
+                    if (h == INF)
+                        return;
+                    int f = succ_g + h;
+                    assert(f >= 0);
+                    assert(f != INF);
+                    push_to_open_list(f, succ_id);
+                    search_info[succ_id].set_incoming_transition(Transition(op_id, state_id));
+                }
+            });
     }
     return UNDEFINED;
 }
@@ -146,19 +275,25 @@ void AbstractSearch::set_h_value(int state_id, int h) {
     search_info[state_id].increase_h_value_to(h);
 }
 
-void AbstractSearch::copy_h_value_to_children(int v, int v1, int v2) {
+void AbstractSearch::handle_split(int v, int v1, int v2) {
     int h = get_h_value(v);
     search_info.resize(search_info.size() + 1);
     set_h_value(v1, h);
     set_h_value(v2, h);
+    if (search_strategy == SearchStrategy::INCREMENTAL) {
+        // v1 reuses the ID of v.
+        assert(v1 == v);
+        split_state_ids.push_back(v1);
+        split_state_ids.push_back(v2);
+    }
 }
 
 
 vector<int> compute_distances(
-    const vector<Transitions> &transitions,
+    const TransitionLists &transitions,
     const vector<int> &costs,
     const unordered_set<int> &start_ids) {
-    vector<int> distances(transitions.size(), INF);
+    vector<int> distances(transitions.get_num_states(), INF);
     priority_queues::AdaptiveQueue<int> open_queue;
     for (int goal_id : start_ids) {
         distances[goal_id] = 0;
@@ -174,18 +309,17 @@ vector<int> compute_distances(
         assert(g <= old_g);
         if (g < old_g)
             continue;
-        assert(utils::in_bounds(state_id, transitions));
-        for (const Transition &transition : transitions[state_id]) {
-            const int op_cost = costs[transition.op_id];
-            assert(op_cost >= 0);
-            int succ_g = (op_cost == INF) ? INF : g + op_cost;
-            assert(succ_g >= 0);
-            int succ_id = transition.target_id;
-            if (succ_g < distances[succ_id]) {
-                distances[succ_id] = succ_g;
-                open_queue.push(succ_g, succ_id);
-            }
-        }
+        transitions.for_each(
+            state_id, [&](int op_id, int succ_id) {
+                const int op_cost = costs[op_id];
+                assert(op_cost >= 0);
+                int succ_g = (op_cost == INF) ? INF : g + op_cost;
+                assert(succ_g >= 0);
+                if (succ_g < distances[succ_id]) {
+                    distances[succ_id] = succ_g;
+                    open_queue.push(succ_g, succ_id);
+                }
+            });
     }
     return distances;
 }
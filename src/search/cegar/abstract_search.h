@@ -2,6 +2,7 @@
 #define CEGAR_ABSTRACT_SEARCH_H
 
 #include "transition.h"
+#include "transition_lists.h"
 #include "types.h"
 
 #include "../algorithms/priority_queues.h"
@@ -13,14 +14,35 @@
 namespace cegar {
 using Solution = std::deque<Transition>;
 
+enum class SearchStrategy {
+    ASTAR,
+    INCREMENTAL
+};
+
 /*
   Find abstract solutions using A*.
+
+  With the incremental search strategy, we do not start each search from
+  scratch but repair the search tree of the previous search. Refining
+  the abstraction only removes abstract paths, so the g values of all
+  states whose path in the search tree avoids the states split since the
+  last search are still costs of abstract paths, and states that have
+  been expanded with their current g value do not need to be expanded
+  again. We reset the search information of the other states, recompute
+  their g values from their expanded predecessors and continue A* with
+  all reached but unexpanded states in the open list. The open list is
+  kept between searches and entries whose h value increased in the
+  meantime are reinserted lazily. We rebuild it when its stale entries
+  outnumber the live ones. Since we reopen states whose g value
+  decreases, the next solution is optimal as well.
 */
 class AbstractSearch {
     class AbstractSearchInfo {
         int g;
         int h;
         Transition incoming_transition;
+        // True iff the state has been expanded with its current g value.
+        bool expanded;
 public:
         AbstractSearchInfo()
             : h(0),
@@ -31,11 +53,21 @@ public:
         void reset() {
             g = std::numeric_limits<int>::max();
             incoming_transition = Transition(UNDEFINED, UNDEFINED);
+            expanded = false;
         }
 
         void decrease_g_value_to(int new_g) {
             assert(new_g <= g);
             g = new_g;
+            expanded = false;
+        }
+
+        void mark_as_expanded() {
+            expanded = true;
+        }
+
+        bool is_expanded() const {
+            return expanded;
         }
 
         int get_g_value() const {
@@ -55,6 +87,10 @@ public:
             incoming_transition = transition;
         }
 
+        bool has_incoming_transition() const {
+            return incoming_transition.op_id != UNDEFINED;
+        }
+
         const Transition &get_incoming_transition() const {
             assert(incoming_transition.op_id != UNDEFINED &&
                    incoming_transition.target_id != UNDEFINED);
@@ -63,32 +99,57 @@ public:
     };
 
     const std::vector<int> operator_costs;
+    const SearchStrategy search_strategy;
 
     // Keep data structures around to avoid reallocating them.
     priority_queues::AdaptiveQueue<int> open_queue;
+    // Number of entries in open_queue, including stale ones.
+    int num_open_entries;
     std::vector<AbstractSearchInfo> search_info;
 
+    // States that have been split since the last search.
+    std::vector<int> split_state_ids;
+    std::vector<bool> is_invalid;
+    bool has_search_tree;
+
     void reset(int num_states);
+    void push_to_open_list(int f, int state_id);
+    // Replace all entries by one entry per reached, unexpanded state.
+    void rebuild_open_list();
     void set_h_value(int state_id, int h);
     std::unique_ptr<Solution> extract_solution(int init_id, int goal_id) const;
     void update_goal_distances(const Solution &solution);
+    /*
+      Prepare continuing the previous search after splitting states (see
+      class comment). Return false if there is no previous search.
+    */
+    bool repair_search_tree(
+        const TransitionLists &outgoing_transitions,
+        const TransitionLists &incoming_transitions, int init_id);
     int astar_search(
-        const std::vector<Transitions> &transitions,
+        const TransitionLists &transitions,
         const Goals &goals);
 
 public:
-    explicit AbstractSearch(const std::vector<int> &operator_costs);
+    AbstractSearch(
+        const std::vector<int> &operator_costs, SearchStrategy search_strategy);
 
     std::unique_ptr<Solution> find_solution(
-        const std::vector<Transitions> &transitions,
+        const TransitionLists &outgoing_transitions,
+        const TransitionLists &incoming_transitions,
         int init_id,
         const Goals &goal_ids);
     int get_h_value(int state_id) const;
-    void copy_h_value_to_children(int v, int v1, int v2);
+    /*
+      Update the search information after state v has been split into
+      v1 and v2. Since h values only increase we can assign the h value
+      of v to the children.
+    */
+    void handle_split(int v, int v1, int v2);
 };
 
 std::vector<int> compute_distances(
-    const std::vector<Transitions> &transitions,
+    const TransitionLists &transitions,
     const std::vector<int> &costs,
     const std::unordered_set<int> &start_ids);
 }
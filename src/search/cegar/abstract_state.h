@@ -64,7 +64,7 @@ public:
 
     // Create the initial, unrefined abstract state.
     static std::unique_ptr<AbstractState> get_trivial_abstract_state(
-        const std::vector<int> &domain_sizes);
+        const VarOffsets &var_offsets);
 };
 }
 
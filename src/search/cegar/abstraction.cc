@@ -4,7 +4,6 @@
 #include "refinement_hierarchy.h"
 #include "transition.h"
 #include "transition_system.h"
-#include "utils.h"
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
@@ -19,13 +18,15 @@
 using namespace std;
 
 namespace cegar {
-Abstraction::Abstraction(const shared_ptr<AbstractTask> &task, utils::LogProxy &log)
+Abstraction::Abstraction(
+    const shared_ptr<AbstractTask> &task, const VarOffsets &var_offsets,
+    utils::LogProxy &log)
     : transition_system(utils::make_unique_ptr<TransitionSystem>(TaskProxy(*task).get_operators())),
       concrete_initial_state(TaskProxy(*task).get_initial_state()),
       goal_facts(task_properties::get_fact_pairs(TaskProxy(*task).get_goals())),
       refinement_hierarchy(utils::make_unique_ptr<RefinementHierarchy>(task)),
       log(log) {
-    initialize_trivial_abstraction(get_domain_sizes(TaskProxy(*task)));
+    initialize_trivial_abstraction(var_offsets);
 }
 
 Abstraction::~Abstraction() {
@@ -63,9 +64,9 @@ void Abstraction::mark_all_states_as_goals() {
     }
 }
 
-void Abstraction::initialize_trivial_abstraction(const vector<int> &domain_sizes) {
+void Abstraction::initialize_trivial_abstraction(const VarOffsets &var_offsets) {
     unique_ptr<AbstractState> init_state =
-        AbstractState::get_trivial_abstract_state(domain_sizes);
+        AbstractState::get_trivial_abstract_state(var_offsets);
     init_id = init_state->get_id();
     goals.insert(init_state->get_id());
     states.push_back(move(init_state));
@@ -43,10 +43,13 @@ class Abstraction {
 
     utils::LogProxy &log;
 
-    void initialize_trivial_abstraction(const std::vector<int> &domain_sizes);
+    void initialize_trivial_abstraction(const VarOffsets &var_offsets);
 
 public:
-    Abstraction(const std::shared_ptr<AbstractTask> &task, utils::LogProxy &log);
+    // The abstract states share the given variable offsets (see CartesianSet).
+    Abstraction(
+        const std::shared_ptr<AbstractTask> &task,
+        const VarOffsets &var_offsets, utils::LogProxy &log);
     ~Abstraction();
 
     Abstraction(const Abstraction &) = delete;
@@ -6,56 +6,141 @@
 #include "utils.h"
 
 #include "../plugins/plugin.h"
+#include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
+#include "../utils/thread_pool.h"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace std;
 
 namespace cegar {
-static vector<CartesianHeuristicFunction> generate_heuristic_functions(
+/*
+  State values converted to the task of the abstraction that is currently
+  evaluated. Reusing the buffer for all abstractions avoids creating a
+  state per abstraction, and using one buffer per thread allows
+  concurrent evaluation.
+*/
+static thread_local vector<int> subtask_values_buffer;
+
+/*
+  We reserve some memory to be able to recover from out-of-memory
+  situations gracefully. When the memory runs out, we stop refining and
+  start the next refinement or the search. Due to memory fragmentation
+  the memory used for building the abstraction (states, transitions,
+  etc.) often can't be reused for things that require big continuous
+  blocks of memory. It is for this reason that we require such a large
+  amount of memory padding.
+*/
+static const int memory_padding_in_mb = 75;
+
+static vector<vector<CartesianHeuristicFunction>> generate_heuristic_functions(
     const plugins::Options &opts, utils::LogProxy &log) {
     if (log.is_at_least_normal()) {
         log << "Initializing additive Cartesian heuristic..." << endl;
     }
+    shared_ptr<AbstractTask> task = opts.get<shared_ptr<AbstractTask>>("transform");
     vector<shared_ptr<SubtaskGenerator>> subtask_generators =
         opts.get_list<shared_ptr<SubtaskGenerator>>("subtasks");
     shared_ptr<utils::RandomNumberGenerator> rng =
         utils::parse_rng_from_options(opts);
-    CostSaturation cost_saturation(
-        subtask_generators,
-        opts.get<int>("max_states"),
-        opts.get<int>("max_transitions"),
-        opts.get<double>("max_time"),
-        opts.get<bool>("use_general_costs"),
-        opts.get<PickSplit>("pick"),
-        *rng,
-        log);
-    return cost_saturation.generate_heuristic_functions(
-        opts.get<shared_ptr<AbstractTask>>("transform"));
+    int num_orders = opts.get<int>("num_orders");
+
+    /*
+      The time limit of each order covers generating the subtasks, which
+      all orders share, and building the abstractions of the order.
+    */
+    utils::CountdownTimer timer(opts.get<double>("max_time"));
+    utils::reserve_extra_memory_padding(memory_padding_in_mb);
+    vector<SharedTasks> subtasks_by_generator;
+    for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
+        subtasks_by_generator.push_back(subtask_generator->get_subtasks(task, log));
+        if (timer.is_expired())
+            break;
+    }
+
+    /*
+      The first order uses the subtasks in the order of the generators and
+      the given random number generator. All other orders shuffle the
+      subtasks of each generator and use their own random number
+      generators and silent logs, so the orders can be computed
+      concurrently.
+    */
+    vector<unique_ptr<utils::RandomNumberGenerator>> order_rngs;
+    vector<vector<SharedTasks>> subtasks_by_order(num_orders, subtasks_by_generator);
+    for (int order = 1; order < num_orders; ++order) {
+        order_rngs.push_back(utils::make_unique_ptr<utils::RandomNumberGenerator>(
+                                 rng->random(numeric_limits<int>::max())));
+        for (SharedTasks &subtasks : subtasks_by_order[order]) {
+            order_rngs.back()->shuffle(subtasks);
+        }
+    }
+
+    int max_states = opts.get<int>("max_states");
+    int max_transitions = opts.get<int>("max_transitions");
+    double max_time = timer.get_remaining_time();
+    bool use_general_costs = opts.get<bool>("use_general_costs");
+    PickSplit pick = opts.get<PickSplit>("pick");
+    SearchStrategy search_strategy = opts.get<SearchStrategy>("search_strategy");
+    int max_flaws_per_solution = opts.get<int>("max_flaws_per_solution");
+    vector<vector<CartesianHeuristicFunction>> functions_by_order(num_orders);
+    utils::ThreadPool thread_pool(min(num_orders, opts.get<int>("num_threads")));
+    thread_pool.parallel_for(
+        num_orders, [&](int order) {
+            utils::LogProxy order_log = (order == 0) ? log : utils::get_silent_log();
+            CostSaturation cost_saturation(
+                max_states,
+                max_transitions,
+                max_time,
+                use_general_costs,
+                pick,
+                search_strategy,
+                max_flaws_per_solution,
+                (order == 0) ? *rng : *order_rngs[order - 1],
+                order_log);
+            functions_by_order[order] = cost_saturation.generate_heuristic_functions(
+                task, subtasks_by_order[order]);
+        });
+    utils::release_extra_memory_padding();
+    if (num_orders > 1 && log.is_at_least_normal()) {
+        log << "Cost-saturation orders: " << num_orders << endl;
+    }
+    return functions_by_order;
 }
 
 AdditiveCartesianHeuristic::AdditiveCartesianHeuristic(
     const plugins::Options &opts)
     : Heuristic(opts),
-      heuristic_functions(generate_heuristic_functions(opts, log)) {
+      heuristic_functions_by_order(generate_heuristic_functions(opts, log)) {
 }
 
 int AdditiveCartesianHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
-    int sum_h = 0;
-    for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
-        assert(value >= 0);
-        if (value == INF)
-            return DEAD_END;
-        sum_h += value;
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    vector<int> &subtask_values = subtask_values_buffer;
+    int max_h = 0;
+    for (const vector<CartesianHeuristicFunction> &heuristic_functions :
+         heuristic_functions_by_order) {
+        int sum_h = 0;
+        for (const CartesianHeuristicFunction &function : heuristic_functions) {
+            subtask_values.assign(values.begin(), values.end());
+            int value = function.get_value(subtask_values, *task);
+            assert(value >= 0);
+            if (value == INF)
+                return DEAD_END;
+            sum_h += value;
+        }
+        assert(sum_h >= 0);
+        max_h = max(max_h, sum_h);
     }
-    assert(sum_h >= 0);
-    return sum_h;
+    return max_h;
 }
 
 class AdditiveCartesianHeuristicFeature
@@ -121,6 +206,37 @@ public:
             "pick",
             "how to choose on which variable to split the flaw state",
             "max_refined");
+        add_option<SearchStrategy>(
+            "search_strategy",
+            "how to find abstract solutions between refinements",
+            "astar");
+        add_option<int>(
+            "max_flaws_per_solution",
+            "maximum number of flaws that are collected along each abstract "
+            "solution and refined before searching for the next solution. "
+            "After the first flaw, we continue tracing the solution with a "
+            "concrete state that is moved into the next abstract state, so "
+            "the flaws are in different abstract states and can be refined "
+            "independently.",
+            "1",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "num_orders",
+            "number of cost-saturation orders. The first order uses the "
+            "subtasks in the order in which the generators produce them. "
+            "All other orders shuffle the subtasks of each generator. The "
+            "heuristic maximizes over the sums of the orders. The limits on "
+            "states, transitions and time apply to each order separately.",
+            "1",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "num_threads",
+            "number of threads used to compute the cost-saturation orders. "
+            "The resulting heuristic does not depend on the number of "
+            "threads unless the abstractions are limited by max_time or "
+            "the memory limit.",
+            "1",
+            plugins::Bounds("1", "infinity"));
         add_option<bool>(
             "use_general_costs",
             "allow negative costs in cost partitioning",
@@ -141,6 +257,14 @@ public:
 
 static plugins::FeaturePlugin<AdditiveCartesianHeuristicFeature> _plugin;
 
+static plugins::TypedEnumPlugin<SearchStrategy> _search_strategy_enum_plugin({
+        {"astar",
+         "run A* from scratch after each refinement"},
+        {"incremental",
+         "repair the search tree of the previous A* search, only "
+         "searching again from the states affected by the refinement"}
+    });
+
 static plugins::TypedEnumPlugin<PickSplit> _enum_plugin({
         {"random",
          "select a random variable (among all eligible variables)"},
@@ -9,17 +9,22 @@ namespace cegar {
 class CartesianHeuristicFunction;
 
 /*
-  Store CartesianHeuristicFunctions and compute overall heuristic by
-  summing all of their values.
+  Store CartesianHeuristicFunctions for one or more cost-saturation
+  orders and compute overall heuristic by summing the values of each
+  order and maximizing over the orders.
 */
 class AdditiveCartesianHeuristic : public Heuristic {
-    const std::vector<CartesianHeuristicFunction> heuristic_functions;
+    const std::vector<std::vector<CartesianHeuristicFunction>> heuristic_functions_by_order;
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 
 public:
     explicit AdditiveCartesianHeuristic(const plugins::Options &opts);
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
@@ -1,22 +1,244 @@
 #include "cartesian_heuristic_function.h"
 
 #include "refinement_hierarchy.h"
+#include "types.h"
+
+#include "../task_proxy.h"
 
 #include "../utils/collections.h"
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
 
 using namespace std;
 
 namespace cegar {
+/*
+  Use a sparse node if a dense node would need more than twice as much
+  memory.
+*/
+static bool use_dense_node(int domain_size, int num_non_default_values) {
+    int dense_size = 1 + domain_size;
+    int sparse_size = 3 + 2 * num_non_default_values;
+    return dense_size <= 2 * sparse_size;
+}
+
+// Call callback(child) with a reference to each child entry of the node.
+template<typename Callback>
+static void for_each_child(vector<int> &compiled_node, const Callback &callback) {
+    if (compiled_node[0] >= 0) {
+        for (size_t i = 1; i < compiled_node.size(); ++i) {
+            callback(compiled_node[i]);
+        }
+    } else {
+        callback(compiled_node[2]);
+        for (size_t i = 4; i < compiled_node.size(); i += 2) {
+            callback(compiled_node[i]);
+        }
+    }
+}
+
+/*
+  Nodes of the compiled hierarchy before they are laid out. Children that
+  are inner nodes are given by their index in the pool, leaves by ~h.
+*/
+class HierarchyCompiler {
+    const RefinementHierarchy &hierarchy;
+    const vector<int> &h_values;
+    vector<int> domain_sizes;
+    vector<vector<int>> pool;
+    utils::HashMap<vector<int>, int> pool_index;
+
+    int add_to_pool(vector<int> &&compiled_node) {
+        auto it = pool_index.find(compiled_node);
+        if (it != pool_index.end()) {
+            return it->second;
+        }
+        int index = pool.size();
+        pool_index.emplace(compiled_node, index);
+        pool.push_back(move(compiled_node));
+        return index;
+    }
+
+    /*
+      Compile the node that tests var and all its descendants that test
+      the same variable. Results for all other descendants must be known.
+    */
+    int compile_node(NodeID node_id, const vector<int> &results) {
+        int var = hierarchy.get_node(node_id).get_var();
+        int domain_size = domain_sizes[var];
+        vector<int> children(domain_size);
+        for (int value = 0; value < domain_size; ++value) {
+            NodeID id = node_id;
+            while (hierarchy.get_node(id).is_split() &&
+                   hierarchy.get_node(id).get_var() == var) {
+                id = hierarchy.get_node(id).get_child(value);
+            }
+            assert(results[id] != UNDEFINED_RESULT);
+            children[value] = results[id];
+        }
+        if (all_of(children.begin(), children.end(),
+                   [&](int child) {return child == children[0];})) {
+            return children[0];
+        }
+
+        // The most frequent child becomes the default child of sparse nodes.
+        vector<int> sorted_children = children;
+        sort(sorted_children.begin(), sorted_children.end());
+        int default_child = sorted_children[0];
+        int max_count = 0;
+        for (size_t i = 0; i < sorted_children.size();) {
+            size_t j = i;
+            while (j < sorted_children.size() &&
+                   sorted_children[j] == sorted_children[i]) {
+                ++j;
+            }
+            if (static_cast<int>(j - i) > max_count) {
+                max_count = j - i;
+                default_child = sorted_children[i];
+            }
+            i = j;
+        }
+        int num_non_default_values = domain_size - max_count;
+
+        vector<int> compiled_node;
+        if (use_dense_node(domain_size, num_non_default_values)) {
+            compiled_node.reserve(1 + domain_size);
+            compiled_node.push_back(var);
+            compiled_node.insert(compiled_node.end(), children.begin(), children.end());
+        } else {
+            compiled_node.reserve(3 + 2 * num_non_default_values);
+            compiled_node.push_back(~var);
+            compiled_node.push_back(num_non_default_values);
+            compiled_node.push_back(default_child);
+            for (int value = 0; value < domain_size; ++value) {
+                if (children[value] != default_child) {
+                    compiled_node.push_back(value);
+                    compiled_node.push_back(children[value]);
+                }
+            }
+        }
+        return add_to_pool(move(compiled_node));
+    }
+
+public:
+    static const int UNDEFINED_RESULT = numeric_limits<int>::min() + 1;
+
+    HierarchyCompiler(
+        const RefinementHierarchy &hierarchy, const vector<int> &h_values)
+        : hierarchy(hierarchy),
+          h_values(h_values) {
+        for (VariableProxy var : TaskProxy(*hierarchy.get_task()).get_variables()) {
+            domain_sizes.push_back(var.get_domain_size());
+        }
+    }
+
+    void compile(vector<int> &code, int &root) {
+        int num_nodes = hierarchy.get_num_nodes();
+
+        /*
+          Only the root and nodes testing another variable than their
+          parents start a new compiled node. (All parents of a node test
+          the same variable.)
+        */
+        vector<bool> starts_node(num_nodes, false);
+        starts_node[0] = true;
+        for (NodeID id = 0; id < num_nodes; ++id) {
+            const Node &node = hierarchy.get_node(id);
+            if (node.is_split()) {
+                for (NodeID child_id : {node.get_left_child(), node.get_right_child()}) {
+                    const Node &child = hierarchy.get_node(child_id);
+                    if (!child.is_split() || child.get_var() != node.get_var()) {
+                        starts_node[child_id] = true;
+                    }
+                }
+            }
+        }
+
+        /*
+          Descendants of a start node have larger IDs than the start node,
+          since start nodes are created as leaves and their descendants
+          are added by later splits. This does not hold for all nodes: a
+          split creates the shared right child before the helper nodes
+          that point to it. Visiting the nodes by decreasing ID therefore
+          compiles all start nodes below a start node before it.
+        */
+        vector<int> results(num_nodes, UNDEFINED_RESULT);
+        for (NodeID id = num_nodes - 1; id >= 0; --id) {
+            if (!starts_node[id]) {
+                continue;
+            }
+            const Node &node = hierarchy.get_node(id);
+            if (node.is_split()) {
+                results[id] = compile_node(id, results);
+            } else {
+                assert(utils::in_bounds(node.get_state_id(), h_values));
+                results[id] = ~h_values[node.get_state_id()];
+            }
+        }
+        int pool_root = results[0];
+        utils::release_vector_memory(results);
+        utils::release_vector_memory(starts_node);
+        pool_index.clear();
+
+        if (pool_root < 0) {
+            // The abstraction has a single heuristic value.
+            root = pool_root;
+            return;
+        }
+
+        // Lay out the pool nodes reachable from the root breadth-first.
+        vector<int> offsets(pool.size(), UNDEFINED);
+        vector<int> order;
+        offsets[pool_root] = 0;
+        order.push_back(pool_root);
+        int next_offset = pool[pool_root].size();
+        for (size_t i = 0; i < order.size(); ++i) {
+            for_each_child(
+                pool[order[i]],
+                [&](int child) {
+                    if (child >= 0 && offsets[child] == UNDEFINED) {
+                        offsets[child] = next_offset;
+                        next_offset += pool[child].size();
+                        order.push_back(child);
+                    }
+                });
+        }
+        code.reserve(next_offset);
+        for (int index : order) {
+            vector<int> &compiled_node = pool[index];
+            for_each_child(
+                compiled_node,
+                [&](int &child) {
+                    if (child >= 0) {
+                        child = offsets[child];
+                    }
+                });
+            code.insert(code.end(), compiled_node.begin(), compiled_node.end());
+            utils::release_vector_memory(compiled_node);
+        }
+        root = 0;
+    }
+};
+
 CartesianHeuristicFunction::CartesianHeuristicFunction(
     unique_ptr<RefinementHierarchy> &&hierarchy,
     vector<int> &&h_values)
-    : refinement_hierarchy(move(hierarchy)),
-      h_values(move(h_values)) {
+    : task(hierarchy->get_task()) {
+    HierarchyCompiler(*hierarchy, h_values).compile(code, root);
 }
 
 int CartesianHeuristicFunction::get_value(const State &state) const {
-    int abstract_state_id = refinement_hierarchy->get_abstract_state_id(state);
-    assert(utils::in_bounds(abstract_state_id, h_values));
-    return h_values[abstract_state_id];
+    State subtask_state = TaskProxy(*task).convert_ancestor_state(state);
+    subtask_state.unpack();
+    return lookup(subtask_state.get_unpacked_values());
+}
+
+int CartesianHeuristicFunction::get_value(
+    vector<int> &state_values, const AbstractTask &ancestor_task) const {
+    task->convert_ancestor_state_values(state_values, &ancestor_task);
+    return lookup(state_values);
 }
 }
@@ -1,21 +1,65 @@
 #ifndef CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 #define CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+class AbstractTask;
 class State;
 
 namespace cegar {
 class RefinementHierarchy;
 /*
-  Store RefinementHierarchy and heuristic values for looking up abstract state
-  IDs and corresponding heuristic values efficiently.
+  Store a compiled version of a RefinementHierarchy whose leaves hold the
+  heuristic values of the abstract states, for looking up heuristic
+  values efficiently.
+
+  The compiled hierarchy is a decision diagram stored in a single
+  vector<int>. We collapse all nodes that test the same variable on a
+  path (the helper nodes of a split and subsequent splits on the same
+  variable) into one node with a child for each value of the variable,
+  and we merge leaves with equal heuristic values, nodes with identical
+  children and nodes whose children are all the same. Inner nodes are
+  laid out in breadth-first order, so the upper levels, which are
+  visited by all lookups, share few cache lines. There are two kinds of
+  inner nodes:
+
+  - Dense nodes [var, child_0, ..., child_{domain_size - 1}].
+  - Sparse nodes [~var, k, default_child, value_1, child_1, ...,
+    value_k, child_k] for variables with large domains of which only a
+    few values are tested.
+
+  Children that are inner nodes are given by their offset, leaves by
+  ~h (which is negative also for h = INF).
 */
 class CartesianHeuristicFunction {
-    // Avoid const to enable moving.
-    std::unique_ptr<RefinementHierarchy> refinement_hierarchy;
-    std::vector<int> h_values;
+    std::shared_ptr<AbstractTask> task;
+    std::vector<int> code;
+    int root;
+
+    int lookup(const std::vector<int> &state_values) const {
+        int node = root;
+        while (node >= 0) {
+            int var = code[node];
+            if (var >= 0) {
+                node = code[node + 1 + state_values[var]];
+            } else {
+                int value = state_values[~var];
+                int num_values = code[node + 1];
+                int next = code[node + 2];
+                const int *entry = &code[node + 3];
+                for (int i = 0; i < num_values; ++i, entry += 2) {
+                    if (entry[0] == value) {
+                        next = entry[1];
+                        break;
+                    }
+                }
+                node = next;
+            }
+        }
+        return ~node;
+    }
 
 public:
     CartesianHeuristicFunction(
@@ -26,6 +70,19 @@ public:
     CartesianHeuristicFunction(CartesianHeuristicFunction &&) = default;
 
     int get_value(const State &state) const;
+
+    /*
+      Return the heuristic value of the state of ancestor_task with the
+      given values. This converts the values to the task of the
+      abstraction in place, so the caller can avoid allocating a new
+      state for each abstraction.
+    */
+    int get_value(
+        std::vector<int> &state_values, const AbstractTask &ancestor_task) const;
+
+    int64_t get_size_in_bytes() const {
+        return code.size() * sizeof(int);
+    }
 };
 }
 
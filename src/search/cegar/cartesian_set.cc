@@ -1,25 +1,60 @@
 #include "cartesian_set.h"
 
-#include <sstream>
+#include <bit>
+#include <cassert>
+#include <string>
 
 using namespace std;
 
 namespace cegar {
-CartesianSet::CartesianSet(const vector<int> &domain_sizes) {
-    domain_subsets.reserve(domain_sizes.size());
+VarOffsets CartesianSet::compute_var_offsets(const vector<int> &domain_sizes) {
+    auto var_offsets = make_shared<vector<int>>();
+    var_offsets->reserve(domain_sizes.size() + 1);
+    var_offsets->push_back(0);
     for (int domain_size : domain_sizes) {
-        Bitset domain(domain_size);
-        domain.set();
-        domain_subsets.push_back(move(domain));
+        var_offsets->push_back(var_offsets->back() + domain_size);
+    }
+    return var_offsets;
+}
+
+CartesianSet::CartesianSet(const VarOffsets &var_offsets)
+    : var_offsets(var_offsets) {
+    int num_bits = var_offsets->back();
+    blocks.resize((num_bits + bits_per_block - 1) / bits_per_block, 0);
+    int num_vars = var_offsets->size() - 1;
+    for (int var = 0; var < num_vars; ++var) {
+        add_all(var);
+    }
+}
+
+template<typename Callback>
+void CartesianSet::for_each_block_of_variable(
+    int var, const Callback &callback) const {
+    int begin = (*var_offsets)[var];
+    int end = (*var_offsets)[var + 1];
+    assert(begin < end);
+    int first_block = begin / bits_per_block;
+    int last_block = (end - 1) / bits_per_block;
+    for (int block = first_block; block <= last_block; ++block) {
+        Block mask = ~Block(0);
+        if (block == first_block) {
+            mask &= ~Block(0) << (begin % bits_per_block);
+        }
+        if (block == last_block && end % bits_per_block != 0) {
+            mask &= ~(~Block(0) << (end % bits_per_block));
+        }
+        callback(block, mask);
     }
 }
 
 void CartesianSet::add(int var, int value) {
-    domain_subsets[var].set(value);
+    int pos = get_offset(var, value);
+    blocks[pos / bits_per_block] |= Block(1) << (pos % bits_per_block);
 }
 
 void CartesianSet::remove(int var, int value) {
-    domain_subsets[var].reset(value);
+    int pos = get_offset(var, value);
+    blocks[pos / bits_per_block] &= ~(Block(1) << (pos % bits_per_block));
 }
 
 void CartesianSet::set_single_value(int var, int value) {
@@ -28,43 +63,61 @@ void CartesianSet::set_single_value(int var, int value) {
 }
 
 void CartesianSet::add_all(int var) {
-    domain_subsets[var].set();
+    for_each_block_of_variable(var, [&](int block, Block mask) {
+                                   blocks[block] |= mask;
+                               });
 }
 
 void CartesianSet::remove_all(int var) {
-    domain_subsets[var].reset();
+    for_each_block_of_variable(var, [&](int block, Block mask) {
+                                   blocks[block] &= ~mask;
+                               });
 }
 
 int CartesianSet::count(int var) const {
-    return domain_subsets[var].count();
+    int result = 0;
+    for_each_block_of_variable(var, [&](int block, Block mask) {
+                                   result += popcount(blocks[block] & mask);
+                               });
+    return result;
 }
 
 bool CartesianSet::intersects(const CartesianSet &other, int var) const {
-    return domain_subsets[var].intersects(other.domain_subsets[var]);
+    assert(var_offsets == other.var_offsets ||
+           *var_offsets == *other.var_offsets);
+    bool result = false;
+    for_each_block_of_variable(var, [&](int block, Block mask) {
+                                   if (blocks[block] & other.blocks[block] & mask)
+                                       result = true;
+                               });
+    return result;
 }
 
 bool CartesianSet::is_superset_of(const CartesianSet &other) const {
-    int num_vars = domain_subsets.size();
-    for (int var = 0; var < num_vars; ++var) {
-        if (!other.domain_subsets[var].is_subset_of(domain_subsets[var]))
+    assert(var_offsets == other.var_offsets ||
+           *var_offsets == *other.var_offsets);
+    // Unused bits are zero in both sets, so we can compare whole blocks.
+    for (size_t block = 0; block < blocks.size(); ++block) {
+        if (other.blocks[block] & ~blocks[block])
             return false;
     }
     return true;
 }
 
 ostream &operator<<(ostream &os, const CartesianSet &cartesian_set) {
-    int num_vars = cartesian_set.domain_subsets.size();
+    int num_vars = cartesian_set.var_offsets->size() - 1;
     string var_sep;
     os << "<";
     for (int var = 0; var < num_vars; ++var) {
-        const Bitset &domain = cartesian_set.domain_subsets[var];
+        int domain_size = (*cartesian_set.var_offsets)[var + 1] -
+            (*cartesian_set.var_offsets)[var];
         vector<int> values;
-        for (size_t value = 0; value < domain.size(); ++value) {
-            if (domain[value])
+        for (int value = 0; value < domain_size; ++value) {
+            if (cartesian_set.test(var, value))
                 values.push_back(value);
         }
         assert(!values.empty());
-        if (values.size() < domain.size()) {
+        if (static_cast<int>(values.size()) < domain_size) {
             os << var_sep << var << "={";
             string value_sep;
             for (int value : values) {
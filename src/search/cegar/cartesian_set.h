@@ -1,24 +1,53 @@
 #ifndef CEGAR_CARTESIAN_SET_H
 #define CEGAR_CARTESIAN_SET_H
 
-#include "../algorithms/dynamic_bitset.h"
+#include "types.h"
 
+#include <cstdint>
+#include <memory>
 #include <ostream>
 #include <vector>
 
 namespace cegar {
-using Bitset = dynamic_bitset::DynamicBitset<unsigned short>;
-
 /*
   For each variable store a subset of its domain.
 
-  The underlying data structure is a vector of bitsets.
+  All subsets are stored in a single bitset, which is split into
+  consecutive ranges of bits, one per variable. The bit offsets of the
+  variables only depend on the domain sizes, so they are computed once
+  per abstraction (see compute_var_offsets()) and shared by all of its
+  Cartesian sets. Compared to storing one
+  bitset per variable, this needs a single allocation per set and
+  operations involving all variables are word-wise loops over contiguous
+  memory.
 */
 class CartesianSet {
-    std::vector<Bitset> domain_subsets;
+    using Block = uint64_t;
+    static const int bits_per_block = 64;
+
+    /*
+      The subset of var is stored in the bits var_offsets[var] (inclusive)
+      to var_offsets[var + 1] (exclusive).
+    */
+    VarOffsets var_offsets;
+    std::vector<Block> blocks;
+
+    int get_offset(int var, int value) const {
+        return (*var_offsets)[var] + value;
+    }
+
+    /*
+      Call callback(block_index, mask) for all blocks overlapping with the
+      bits of var, where mask selects the bits of var in the block.
+    */
+    template<typename Callback>
+    void for_each_block_of_variable(int var, const Callback &callback) const;
 
 public:
-    explicit CartesianSet(const std::vector<int> &domain_sizes);
+    // Create the set containing all values of all variables.
+    explicit CartesianSet(const VarOffsets &var_offsets);
+
+    static VarOffsets compute_var_offsets(const std::vector<int> &domain_sizes);
 
     void add(int var, int value);
     void set_single_value(int var, int value);
@@ -27,7 +56,8 @@ public:
     void remove_all(int var);
 
     bool test(int var, int value) const {
-        return domain_subsets[var][value];
+        int pos = get_offset(var, value);
+        return (blocks[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
     }
 
     int count(int var) const;
@@ -22,8 +22,8 @@ using namespace std;
 namespace cegar {
 // Create the Cartesian set that corresponds to the given preconditions or goals.
 static CartesianSet get_cartesian_set(
-    const vector<int> &domain_sizes, const ConditionsProxy &conditions) {
-    CartesianSet cartesian_set(domain_sizes);
+    const VarOffsets &var_offsets, const ConditionsProxy &conditions) {
+    CartesianSet cartesian_set(var_offsets);
     for (FactProxy condition : conditions) {
         cartesian_set.set_single_value(
             condition.get_variable().get_id(), condition.get_value());
@@ -31,6 +31,28 @@ static CartesianSet get_cartesian_set(
     return cartesian_set;
 }
 
+/*
+  Return the state that agrees with the given concrete state on all
+  variables whose value is contained in the abstract state and has the
+  smallest value contained in the abstract state for all other variables.
+*/
+static State move_into_abstract_state(
+    const TaskProxy &task_proxy, const State &concrete_state,
+    const AbstractState &abstract_state) {
+    concrete_state.unpack();
+    vector<int> values = concrete_state.get_unpacked_values();
+    for (size_t var = 0; var < values.size(); ++var) {
+        if (!abstract_state.contains(var, values[var])) {
+            int value = 0;
+            while (!abstract_state.contains(var, value)) {
+                ++value;
+            }
+            values[var] = value;
+        }
+    }
+    return task_proxy.create_state(move(values));
+}
+
 struct Flaw {
     // Last concrete and abstract state reached while tracing solution.
     State concrete_state;
@@ -84,15 +106,19 @@ CEGAR::CEGAR(
     int max_non_looping_transitions,
     double max_time,
     PickSplit pick,
+    SearchStrategy search_strategy,
+    int max_flaws_per_solution,
     utils::RandomNumberGenerator &rng,
     utils::LogProxy &log)
     : task_proxy(*task),
-      domain_sizes(get_domain_sizes(task_proxy)),
+      var_offsets(CartesianSet::compute_var_offsets(get_domain_sizes(task_proxy))),
       max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
+      max_flaws_per_solution(max_flaws_per_solution),
       split_selector(task, pick),
-      abstraction(utils::make_unique_ptr<Abstraction>(task, log)),
-      abstract_search(task_properties::get_operator_costs(task_proxy)),
+      abstraction(utils::make_unique_ptr<Abstraction>(task, var_offsets, log)),
+      abstract_search(
+          task_properties::get_operator_costs(task_proxy), search_strategy),
       timer(max_time),
       log(log) {
     assert(max_states >= 1);
@@ -187,6 +213,7 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         find_trace_timer.resume();
         unique_ptr<Solution> solution = abstract_search.find_solution(
             abstraction->get_transition_system().get_outgoing_transitions(),
+            abstraction->get_transition_system().get_incoming_transitions(),
             abstraction->get_initial_state().get_id(),
             abstraction->get_goals());
         find_trace_timer.stop();
@@ -198,32 +225,41 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         }
 
         find_flaw_timer.resume();
-        unique_ptr<Flaw> flaw = find_flaw(*solution);
+        vector<unique_ptr<Flaw>> flaws = find_flaws(*solution);
         find_flaw_timer.stop();
-        if (!flaw) {
+        if (flaws.empty()) {
             if (log.is_at_least_normal()) {
                 log << "Found concrete solution during refinement." << endl;
             }
             break;
         }
 
+        /*
+          All flaws are in different abstract states, so refining one of
+          them leaves the abstract states of the others intact. We only
+          check the state limit between the refinements of a batch and
+          let the loop condition check the other limits.
+        */
         refine_timer.resume();
-        const AbstractState &abstract_state = flaw->current_abstract_state;
-        int state_id = abstract_state.get_id();
-        vector<Split> splits = flaw->get_possible_splits();
-        const Split &split = split_selector.pick_split(abstract_state, splits, rng);
-        auto new_state_ids = abstraction->refine(abstract_state, split.var_id, split.values);
-        // Since h-values only increase we can assign the h-value to the children.
-        abstract_search.copy_h_value_to_children(
-            state_id, new_state_ids.first, new_state_ids.second);
-        refine_timer.stop();
+        for (const unique_ptr<Flaw> &flaw : flaws) {
+            if (abstraction->get_num_states() >= max_states)
+                break;
+            const AbstractState &abstract_state = flaw->current_abstract_state;
+            int state_id = abstract_state.get_id();
+            vector<Split> splits = flaw->get_possible_splits();
+            const Split &split = split_selector.pick_split(abstract_state, splits, rng);
+            auto new_state_ids = abstraction->refine(abstract_state, split.var_id, split.values);
+            abstract_search.handle_split(
+                state_id, new_state_ids.first, new_state_ids.second);
 
-        if (log.is_at_least_verbose() &&
-            abstraction->get_num_states() % 1000 == 0) {
-            log << abstraction->get_num_states() << "/" << max_states << " states, "
-                << abstraction->get_transition_system().get_num_non_loops() << "/"
-                << max_non_looping_transitions << " transitions" << endl;
+            if (log.is_at_least_verbose() &&
+                abstraction->get_num_states() % 1000 == 0) {
+                log << abstraction->get_num_states() << "/" << max_states << " states, "
+                    << abstraction->get_transition_system().get_num_non_loops() << "/"
+                    << max_non_looping_transitions << " transitions" << endl;
+            }
         }
+        refine_timer.stop();
     }
     if (log.is_at_least_normal()) {
         log << "Time for finding abstract traces: " << find_trace_timer << endl;
@@ -232,10 +268,15 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
     }
 }
 
-unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
+vector<unique_ptr<Flaw>> CEGAR::find_flaws(const Solution &solution) {
     if (log.is_at_least_debug())
         log << "Check solution:" << endl;
 
+    vector<unique_ptr<Flaw>> flaws;
+    auto has_enough_flaws = [&]() {
+            return static_cast<int>(flaws.size()) >= max_flaws_per_solution;
+        };
+
     const AbstractState *abstract_state = &abstraction->get_initial_state();
     State concrete_state = task_proxy.get_initial_state();
     assert(abstract_state->includes(concrete_state));
@@ -256,34 +297,54 @@ unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
             if (!next_abstract_state->includes(next_concrete_state)) {
                 if (log.is_at_least_debug())
                     log << "  Paths deviate." << endl;
-                return utils::make_unique_ptr<Flaw>(
-                    move(concrete_state),
-                    *abstract_state,
-                    next_abstract_state->regress(op));
+                flaws.push_back(utils::make_unique_ptr<Flaw>(
+                                    State(concrete_state),
+                                    *abstract_state,
+                                    next_abstract_state->regress(op)));
+                if (has_enough_flaws())
+                    return flaws;
+                next_concrete_state = move_into_abstract_state(
+                    task_proxy, next_concrete_state, *next_abstract_state);
             }
             abstract_state = next_abstract_state;
             concrete_state = move(next_concrete_state);
         } else {
             if (log.is_at_least_debug())
                 log << "  Operator not applicable: " << op.get_name() << endl;
-            return utils::make_unique_ptr<Flaw>(
-                move(concrete_state),
-                *abstract_state,
-                get_cartesian_set(domain_sizes, op.get_preconditions()));
+            flaws.push_back(utils::make_unique_ptr<Flaw>(
+                                State(concrete_state),
+                                *abstract_state,
+                                get_cartesian_set(var_offsets, op.get_preconditions())));
+            if (has_enough_flaws())
+                return flaws;
+            /*
+              The abstract state contains all preconditions of op, so we
+              can make op applicable without leaving the abstract state.
+            */
+            concrete_state.unpack();
+            vector<int> values = concrete_state.get_unpacked_values();
+            for (FactProxy precondition : op.get_preconditions()) {
+                FactPair fact = precondition.get_pair();
+                values[fact.var] = fact.value;
+            }
+            State next_concrete_state = task_proxy.create_state(move(values))
+                .get_unregistered_successor(op);
+            abstract_state = next_abstract_state;
+            concrete_state = move_into_abstract_state(
+                task_proxy, next_concrete_state, *abstract_state);
         }
     }
     assert(abstraction->get_goals().count(abstract_state->get_id()));
-    if (task_properties::is_goal_state(task_proxy, concrete_state)) {
-        // We found a concrete solution.
-        return nullptr;
-    } else {
+    if (!task_properties::is_goal_state(task_proxy, concrete_state)) {
         if (log.is_at_least_debug())
             log << "  Goal test failed." << endl;
-        return utils::make_unique_ptr<Flaw>(
-            move(concrete_state),
-            *abstract_state,
-            get_cartesian_set(domain_sizes, task_proxy.get_goals()));
+        flaws.push_back(utils::make_unique_ptr<Flaw>(
+                            move(concrete_state),
+                            *abstract_state,
+                            get_cartesian_set(var_offsets, task_proxy.get_goals())));
     }
+    // If there are no flaws, we found a concrete solution.
+    return flaws;
 }
 
 void CEGAR::print_statistics() {
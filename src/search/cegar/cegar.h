@@ -3,12 +3,14 @@
 
 #include "abstract_search.h"
 #include "split_selector.h"
+#include "types.h"
 
 #include "../task_proxy.h"
 
 #include "../utils/countdown_timer.h"
 
 #include <memory>
+#include <vector>
 
 namespace utils {
 class RandomNumberGenerator;
@@ -29,9 +31,11 @@ struct Flaw;
 */
 class CEGAR {
     const TaskProxy task_proxy;
-    const std::vector<int> domain_sizes;
+    // Shared by all Cartesian sets of the abstraction and its flaws.
+    const VarOffsets var_offsets;
     const int max_states;
     const int max_non_looping_transitions;
+    const int max_flaws_per_solution;
     const SplitSelector split_selector;
 
     std::unique_ptr<Abstraction> abstraction;
@@ -54,9 +58,10 @@ class CEGAR {
     */
     void separate_facts_unreachable_before_goal();
 
-    /* Try to convert the abstract solution into a concrete trace. Return the
-       first encountered flaw or nullptr if there is no flaw. */
-    std::unique_ptr<Flaw> find_flaw(const Solution &solution);
+    /* Try to convert the abstract solution into a concrete trace. Return
+       the first encountered flaws (at most max_flaws_per_solution) or an
+       empty vector if there is no flaw. */
+    std::vector<std::unique_ptr<Flaw>> find_flaws(const Solution &solution);
 
     // Build abstraction.
     void refinement_loop(utils::RandomNumberGenerator &rng);
@@ -70,6 +75,8 @@ public:
         int max_non_looping_transitions,
         double max_time,
         PickSplit pick,
+        SearchStrategy search_strategy,
+        int max_flaws_per_solution,
         utils::RandomNumberGenerator &rng,
         utils::LogProxy &log);
     ~CEGAR();
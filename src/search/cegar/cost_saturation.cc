@@ -17,21 +17,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 
 using namespace std;
 
 namespace cegar {
-/*
-  We reserve some memory to be able to recover from out-of-memory
-  situations gracefully. When the memory runs out, we stop refining and
-  start the next refinement or the search. Due to memory fragmentation
-  the memory used for building the abstraction (states, transitions,
-  etc.) often can't be reused for things that require big continuous
-  blocks of memory. It is for this reason that we require such a large
-  amount of memory padding.
-*/
-static const int memory_padding_in_mb = 75;
-
 static vector<int> compute_saturated_costs(
     const TransitionSystem &transition_system,
     const vector<int> &g_values,
@@ -56,25 +46,24 @@ static vector<int> compute_saturated_costs(
         if (g == INF || h == INF)
             continue;
 
-        for (const Transition &transition:
-             transition_system.get_outgoing_transitions()[state_id]) {
-            int op_id = transition.op_id;
-            int succ_id = transition.target_id;
-            int succ_h = h_values[succ_id];
+        transition_system.get_outgoing_transitions().for_each(
+            state_id, [&](int op_id, int succ_id) {
+                int succ_h = h_values[succ_id];
 
-            if (succ_h == INF)
-                continue;
+                if (succ_h == INF)
+                    return;
 
-            int needed = h - succ_h;
-            saturated_costs[op_id] = max(saturated_costs[op_id], needed);
-        }
+                int needed = h - succ_h;
+                saturated_costs[op_id] = max(saturated_costs[op_id], needed);
+            });
 
         if (use_general_costs) {
             /* To prevent negative cost cycles, all operators inducing
                self-loops must have non-negative costs. */
-            for (int op_id : transition_system.get_loops()[state_id]) {
-                saturated_costs[op_id] = max(saturated_costs[op_id], 0);
-            }
+            transition_system.for_each_loop(
+                state_id, [&](int op_id) {
+                    saturated_costs[op_id] = max(saturated_costs[op_id], 0);
+                });
         }
     }
     return saturated_costs;
@@ -82,20 +71,22 @@ static vector<int> compute_saturated_costs(
 
 
 CostSaturation::CostSaturation(
-    const vector<shared_ptr<SubtaskGenerator>> &subtask_generators,
     int max_states,
     int max_non_looping_transitions,
     double max_time,
     bool use_general_costs,
     PickSplit pick_split,
+    SearchStrategy search_strategy,
+    int max_flaws_per_solution,
     utils::RandomNumberGenerator &rng,
     utils::LogProxy &log)
-    : subtask_generators(subtask_generators),
-      max_states(max_states),
+    : max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
       max_time(max_time),
       use_general_costs(use_general_costs),
       pick_split(pick_split),
+      search_strategy(search_strategy),
+      max_flaws_per_solution(max_flaws_per_solution),
       rng(rng),
       log(log),
       num_abstractions(0),
@@ -104,7 +95,8 @@ CostSaturation::CostSaturation(
 }
 
 vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
-    const shared_ptr<AbstractTask> &task) {
+    const shared_ptr<AbstractTask> &task,
+    const vector<SharedTasks> &subtasks_by_generator) {
     // For simplicity this is a member object. Make sure it is in a valid state.
     assert(heuristic_functions.empty());
 
@@ -128,15 +120,11 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
                    state_is_dead_end(initial_state);
         };
 
-    utils::reserve_extra_memory_padding(memory_padding_in_mb);
-    for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
-        SharedTasks subtasks = subtask_generator->get_subtasks(task, log);
+    for (const SharedTasks &subtasks : subtasks_by_generator) {
         build_abstractions(subtasks, timer, should_abort);
         if (should_abort())
             break;
     }
-    if (utils::extra_memory_padding_is_reserved())
-        utils::release_extra_memory_padding();
     print_statistics(timer.get_elapsed_time());
 
     vector<CartesianHeuristicFunction> functions;
@@ -203,6 +191,8 @@ void CostSaturation::build_abstractions(
                 rem_subtasks),
             timer.get_remaining_time() / rem_subtasks,
             pick_split,
+            search_strategy,
+            max_flaws_per_solution,
             rng,
             log);
 
@@ -249,6 +239,12 @@ void CostSaturation::print_statistics(utils::Duration init_time) const {
         log << "Cartesian states: " << num_states << endl;
         log << "Total number of non-looping transitions: "
             << num_non_looping_transitions << endl;
+        int64_t hierarchy_size_in_bytes = 0;
+        for (const CartesianHeuristicFunction &function : heuristic_functions) {
+            hierarchy_size_in_bytes += function.get_size_in_bytes();
+        }
+        log << "Compiled refinement hierarchies: "
+            << hierarchy_size_in_bytes / 1024 << " KB" << endl;
         log << endl;
     }
 }
@@ -1,8 +1,10 @@
 #ifndef CEGAR_COST_SATURATION_H
 #define CEGAR_COST_SATURATION_H
 
+#include "abstract_search.h"
 #include "refinement_hierarchy.h"
 #include "split_selector.h"
+#include "subtask_generators.h"
 
 #include <memory>
 #include <vector>
@@ -16,22 +18,25 @@ class LogProxy;
 
 namespace cegar {
 class CartesianHeuristicFunction;
-class SubtaskGenerator;
 
 /*
-  Get subtasks from SubtaskGenerators, reduce their costs by wrapping
-  them in ModifiedOperatorCostsTasks, compute Abstractions, move
+  Reduce the costs of the given subtasks by wrapping them in
+  ModifiedOperatorCostsTasks, compute Abstractions, move
   RefinementHierarchies from Abstractions to
   CartesianHeuristicFunctions, allow extracting
   CartesianHeuristicFunctions into AdditiveCartesianHeuristic.
+
+  A CostSaturation object computes a single cost-saturation order. The
+  caller is responsible for reserving the extra memory padding.
 */
 class CostSaturation {
-    const std::vector<std::shared_ptr<SubtaskGenerator>> subtask_generators;
     const int max_states;
     const int max_non_looping_transitions;
     const double max_time;
     const bool use_general_costs;
     const PickSplit pick_split;
+    const SearchStrategy search_strategy;
+    const int max_flaws_per_solution;
     utils::RandomNumberGenerator &rng;
     utils::LogProxy &log;
 
@@ -54,17 +59,23 @@ class CostSaturation {
 
 public:
     CostSaturation(
-        const std::vector<std::shared_ptr<SubtaskGenerator>> &subtask_generators,
         int max_states,
         int max_non_looping_transitions,
         double max_time,
         bool use_general_costs,
         PickSplit pick_split,
+        SearchStrategy search_strategy,
+        int max_flaws_per_solution,
         utils::RandomNumberGenerator &rng,
         utils::LogProxy &log);
 
+    /*
+      Build abstractions for the subtasks of each generator in the given
+      order, saturating the costs of each abstraction.
+    */
     std::vector<CartesianHeuristicFunction> generate_heuristic_functions(
-        const std::shared_ptr<AbstractTask> &task);
+        const std::shared_ptr<AbstractTask> &task,
+        const std::vector<SharedTasks> &subtasks_by_generator);
 };
 }
 
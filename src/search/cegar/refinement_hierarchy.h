@@ -48,6 +48,20 @@ public:
         int left_state_id, int right_state_id);
 
     int get_abstract_state_id(const State &state) const;
+
+    const std::shared_ptr<AbstractTask> &get_task() const {
+        return task;
+    }
+
+    /* Children always have larger IDs than their parents. The root has
+       ID 0. */
+    int get_num_nodes() const {
+        return nodes.size();
+    }
+
+    const Node &get_node(NodeID node_id) const {
+        return nodes[node_id];
+    }
 };
 
 
@@ -83,6 +97,21 @@ public:
         return var;
     }
 
+    int get_value() const {
+        assert(is_split());
+        return value;
+    }
+
+    NodeID get_left_child() const {
+        assert(is_split());
+        return left_child;
+    }
+
+    NodeID get_right_child() const {
+        assert(is_split());
+        return right_child;
+    }
+
     NodeID get_child(int value) const {
         assert(is_split());
         if (value == this->value)
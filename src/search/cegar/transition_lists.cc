@@ -0,0 +1,91 @@
+#include "transition_lists.h"
+
+#include "transition.h"
+
+#include "../utils/language.h"
+
+#include <algorithm>
+#include <bit>
+
+using namespace std;
+
+namespace cegar {
+static int get_num_operator_bits(int num_operators) {
+    assert(num_operators >= 0);
+    return num_operators <= 1 ? 0 : bit_width(static_cast<uint32_t>(num_operators - 1));
+}
+
+TransitionLists::TransitionLists(int num_operators)
+    : num_operator_bits(get_num_operator_bits(num_operators)),
+      operator_mask(static_cast<uint32_t>((uint64_t(1) << num_operator_bits) - 1)),
+      is_packed(true) {
+}
+
+void TransitionLists::unpack() {
+    assert(is_packed);
+    for (vector<uint32_t> &list : lists) {
+        vector<uint32_t> unpacked_list;
+        unpacked_list.reserve(2 * list.size());
+        for (uint32_t word : list) {
+            unpacked_list.push_back(word & operator_mask);
+            unpacked_list.push_back(word >> num_operator_bits);
+        }
+        list = move(unpacked_list);
+    }
+    is_packed = false;
+}
+
+void TransitionLists::add_state() {
+    uint64_t new_state_id = lists.size();
+    if (is_packed && (new_state_id >> (32 - num_operator_bits)) != 0) {
+        unpack();
+    }
+    lists.emplace_back();
+}
+
+void TransitionLists::add_transition(int state_id, int op_id, int other_id) {
+    assert(state_id >= 0 && state_id < get_num_states());
+    assert(other_id >= 0 && other_id < get_num_states());
+    assert(op_id >= 0 && static_cast<uint32_t>(op_id) <= operator_mask);
+    vector<uint32_t> &list = lists[state_id];
+    if (is_packed) {
+        list.push_back((static_cast<uint32_t>(other_id) << num_operator_bits) | op_id);
+    } else {
+        list.push_back(op_id);
+        list.push_back(other_id);
+    }
+}
+
+void TransitionLists::remove_transitions_with_given_target(
+    int state_id, int other_id) {
+    vector<uint32_t> &list = lists[state_id];
+    size_t old_size = list.size();
+    if (is_packed) {
+        list.erase(remove_if(list.begin(), list.end(),
+                             [&](uint32_t word) {
+                                 return static_cast<int>(word >> num_operator_bits) == other_id;
+                             }),
+                   list.end());
+    } else {
+        size_t new_size = 0;
+        for (size_t i = 0; i < list.size(); i += 2) {
+            if (static_cast<int>(list[i + 1]) != other_id) {
+                list[new_size++] = list[i];
+                list[new_size++] = list[i + 1];
+            }
+        }
+        list.resize(new_size);
+    }
+    assert(list.size() < old_size);
+    utils::unused_variable(old_size);
+}
+
+void TransitionLists::extract_transitions(int state_id, Transitions &transitions) {
+    for_each(state_id, [&](int op_id, int other_id) {
+                 transitions.emplace_back(op_id, other_id);
+             });
+    /* The state keeps its ID after the split, so we keep the memory for
+       the transitions of the first child. */
+    lists[state_id].clear();
+}
+}
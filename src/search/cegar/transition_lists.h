@@ -0,0 +1,75 @@
+#ifndef CEGAR_TRANSITION_LISTS_H
+#define CEGAR_TRANSITION_LISTS_H
+
+#include "types.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace cegar {
+/*
+  Store the non-looping transitions of each abstract state in one
+  direction, i.e., the pairs (operator, other state) of all outgoing or
+  of all incoming transitions.
+
+  As long as the operator and state IDs fit into 32 bits together, we
+  pack each pair into a single word with the operator ID in the low bits.
+  This halves the memory usage compared to storing two ints. When we add
+  a state whose ID does not fit anymore, we convert all lists to two
+  words per pair.
+*/
+class TransitionLists {
+    const int num_operator_bits;
+    const uint32_t operator_mask;
+    bool is_packed;
+    std::vector<std::vector<uint32_t>> lists;
+
+    int get_words_per_transition() const {
+        return is_packed ? 1 : 2;
+    }
+
+    void unpack();
+
+public:
+    explicit TransitionLists(int num_operators);
+
+    void add_state();
+    void add_transition(int state_id, int op_id, int other_id);
+    // Remove all transitions to (or from) the given other state.
+    void remove_transitions_with_given_target(int state_id, int other_id);
+    // Append the transitions of the state to the given vector and clear them.
+    void extract_transitions(int state_id, Transitions &transitions);
+
+    // Call callback(op_id, other_id) for all transitions of the state.
+    template<typename Callback>
+    void for_each(int state_id, const Callback &callback) const {
+        assert(state_id >= 0 && state_id < get_num_states());
+        const std::vector<uint32_t> &list = lists[state_id];
+        if (is_packed) {
+            for (uint32_t word : list) {
+                callback(static_cast<int>(word & operator_mask),
+                         static_cast<int>(word >> num_operator_bits));
+            }
+        } else {
+            for (size_t i = 0; i < list.size(); i += 2) {
+                callback(static_cast<int>(list[i]), static_cast<int>(list[i + 1]));
+            }
+        }
+    }
+
+    int get_num_transitions(int state_id) const {
+        return lists[state_id].size() / get_words_per_transition();
+    }
+
+    int get_num_states() const {
+        return lists.size();
+    }
+
+    bool uses_packed_transitions() const {
+        return is_packed;
+    }
+};
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <map>
+#include <numeric>
 
 using namespace std;
 
@@ -68,21 +69,62 @@ static int lookup_value(const vector<FactPair> &facts, int var) {
     return UNDEFINED;
 }
 
-static void remove_transitions_with_given_target(
-    Transitions &transitions, int state_id) {
-    auto new_end = remove_if(
-        transitions.begin(), transitions.end(),
-        [state_id](const Transition &t) {return t.target_id == state_id;});
-    assert(new_end != transitions.end());
-    transitions.erase(new_end, transitions.end());
+
+void TransitionSystem::Loops::assign(
+    const vector<int> &sorted_op_ids, int num_operators) {
+    assert(is_sorted(sorted_op_ids.begin(), sorted_op_ids.end()));
+    num_loops = sorted_op_ids.size();
+    // A bitset needs less memory than a list if there are more than two IDs per block.
+    int num_blocks = (num_operators + 63) / 64;
+    if (num_loops > 2 * num_blocks) {
+        op_ids = vector<int>();
+        op_bits.assign(num_blocks, 0);
+        for (int op_id : sorted_op_ids) {
+            op_bits[op_id / 64] |= uint64_t(1) << (op_id % 64);
+        }
+    } else {
+        op_bits = vector<uint64_t>();
+        op_ids.assign(sorted_op_ids.begin(), sorted_op_ids.end());
+    }
+}
+
+void TransitionSystem::Loops::assign(vector<uint64_t> &&bits) {
+    num_loops = 0;
+    for (uint64_t block : bits) {
+        num_loops += popcount(block);
+    }
+    int num_blocks = bits.size();
+    if (num_loops > 2 * num_blocks) {
+        op_ids = vector<int>();
+        op_bits = move(bits);
+    } else {
+        op_bits = vector<uint64_t>();
+        op_ids.clear();
+        op_ids.reserve(num_loops);
+        for (int block = 0; block < num_blocks; ++block) {
+            for (uint64_t b = bits[block]; b; b &= b - 1) {
+                op_ids.push_back(block * 64 + countr_zero(b));
+            }
+        }
+    }
 }
 
 
 TransitionSystem::TransitionSystem(const OperatorsProxy &ops)
     : preconditions_by_operator(get_preconditions_by_operator(ops)),
       postconditions_by_operator(get_postconditions_by_operator(ops)),
+      incoming(ops.size()),
+      outgoing(ops.size()),
       num_non_loops(0),
       num_loops(0) {
+    for (size_t op_id = 0; op_id < postconditions_by_operator.size(); ++op_id) {
+        for (const FactPair &fact : postconditions_by_operator[op_id]) {
+            if (fact.var >= static_cast<int>(operators_by_variable.size())) {
+                operators_by_variable.resize(fact.var + 1);
+            }
+            operators_by_variable[fact.var].push_back(op_id);
+        }
+    }
     add_loops_in_trivial_abstraction();
 }
 
@@ -96,8 +138,8 @@ int TransitionSystem::get_postcondition_value(int op_id, int var) const {
 
 void TransitionSystem::enlarge_vectors_by_one() {
     int new_num_states = get_num_states() + 1;
-    outgoing.resize(new_num_states);
-    incoming.resize(new_num_states);
+    outgoing.add_state();
+    incoming.add_state();
     loops.resize(new_num_states);
 }
 
@@ -105,24 +147,19 @@ void TransitionSystem::add_loops_in_trivial_abstraction() {
     assert(get_num_states() == 0);
     enlarge_vectors_by_one();
     int init_id = 0;
-    for (int i = 0; i < get_num_operators(); ++i) {
-        add_loop(init_id, i);
-    }
+    vector<int> op_ids(get_num_operators());
+    iota(op_ids.begin(), op_ids.end(), 0);
+    loops[init_id].assign(op_ids, get_num_operators());
+    num_loops += op_ids.size();
 }
 
 void TransitionSystem::add_transition(int src_id, int op_id, int target_id) {
     assert(src_id != target_id);
-    outgoing[src_id].emplace_back(op_id, target_id);
-    incoming[target_id].emplace_back(op_id, src_id);
+    outgoing.add_transition(src_id, op_id, target_id);
+    incoming.add_transition(target_id, op_id, src_id);
     ++num_non_loops;
 }
 
-void TransitionSystem::add_loop(int state_id, int op_id) {
-    assert(utils::in_bounds(state_id, loops));
-    loops[state_id].push_back(op_id);
-    ++num_loops;
-}
-
 void TransitionSystem::rewire_incoming_transitions(
     const Transitions &old_incoming, const AbstractStates &states,
     const AbstractState &v1, const AbstractState &v2, int var) {
@@ -136,7 +173,7 @@ void TransitionSystem::rewire_incoming_transitions(
         int u_id = transition.target_id;
         bool is_new_state = updated_states.insert(u_id).second;
         if (is_new_state) {
-            remove_transitions_with_given_target(outgoing[u_id], v1_id);
+            outgoing.remove_transitions_with_given_target(u_id, v1_id);
         }
     }
     num_non_loops -= old_incoming.size();
@@ -181,7 +218,7 @@ void TransitionSystem::rewire_outgoing_transitions(
         int w_id = transition.target_id;
         bool is_new_state = updated_states.insert(w_id).second;
         if (is_new_state) {
-            remove_transitions_with_given_target(incoming[w_id], v1_id);
+            incoming.remove_transitions_with_given_target(w_id, v1_id);
         }
     }
     num_non_loops -= old_outgoing.size();
@@ -226,90 +263,143 @@ void TransitionSystem::rewire_loops(
        v2->v1 and v2->v2. */
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
-    for (int op_id : old_loops) {
-        int pre = get_precondition_value(op_id, var);
-        int post = get_postcondition_value(op_id, var);
-        if (pre == UNDEFINED) {
-            // op has no precondition on var --> it must start in v1 and v2.
-            if (post == UNDEFINED) {
-                // op has no effect on var --> it must end in v1 and v2.
-                add_loop(v1_id, op_id);
-                add_loop(v2_id, op_id);
-            } else if (v2.contains(var, post)) {
-                // op must end in v2.
-                add_transition(v1_id, op_id, v2_id);
-                add_loop(v2_id, op_id);
-            } else {
-                // op must end in v1.
-                assert(v1.contains(var, post));
-                add_loop(v1_id, op_id);
-                add_transition(v2_id, op_id, v1_id);
-            }
-        } else if (v1.contains(var, pre)) {
-            // op must start in v1.
-            assert(post != UNDEFINED);
-            if (v1.contains(var, post)) {
-                // op must end in v1.
-                add_loop(v1_id, op_id);
+    assert(v1_loops.empty() && v2_loops.empty());
+    auto rewire_loop = [&](int op_id, auto add_v1_loop, auto add_v2_loop) {
+            int pre = get_precondition_value(op_id, var);
+            int post = get_postcondition_value(op_id, var);
+            if (pre == UNDEFINED) {
+                // op has no precondition on var --> it must start in v1 and v2.
+                if (post == UNDEFINED) {
+                    // op has no effect on var --> it must end in v1 and v2.
+                    add_v1_loop(op_id);
+                    add_v2_loop(op_id);
+                } else if (v2.contains(var, post)) {
+                    // op must end in v2.
+                    add_transition(v1_id, op_id, v2_id);
+                    add_v2_loop(op_id);
+                } else {
+                    // op must end in v1.
+                    assert(v1.contains(var, post));
+                    add_v1_loop(op_id);
+                    add_transition(v2_id, op_id, v1_id);
+                }
+            } else if (v1.contains(var, pre)) {
+                // op must start in v1.
+                assert(post != UNDEFINED);
+                if (v1.contains(var, post)) {
+                    // op must end in v1.
+                    add_v1_loop(op_id);
+                } else {
+                    // op must end in v2.
+                    assert(v2.contains(var, post));
+                    add_transition(v1_id, op_id, v2_id);
+                }
             } else {
-                // op must end in v2.
-                assert(v2.contains(var, post));
-                add_transition(v1_id, op_id, v2_id);
+                // op must start in v2.
+                assert(v2.contains(var, pre));
+                assert(post != UNDEFINED);
+                if (v1.contains(var, post)) {
+                    // op must end in v1.
+                    add_transition(v2_id, op_id, v1_id);
+                } else {
+                    // op must end in v2.
+                    assert(v2.contains(var, post));
+                    add_v2_loop(op_id);
+                }
             }
-        } else {
-            // op must start in v2.
-            assert(v2.contains(var, pre));
-            assert(post != UNDEFINED);
-            if (v1.contains(var, post)) {
-                // op must end in v1.
-                add_transition(v2_id, op_id, v1_id);
-            } else {
-                // op must end in v2.
-                assert(v2.contains(var, post));
-                add_loop(v2_id, op_id);
+        };
+
+    if (old_loops.is_bitset()) {
+        /*
+          Operators without postcondition on var induce self-loops in v1
+          and v2, so we only need to look at the operators with a
+          postcondition on var, which we visit in increasing order, like
+          all other loops.
+        */
+        const vector<uint64_t> &old_bits = old_loops.get_bits();
+        vector<uint64_t> v1_bits = old_bits;
+        static const vector<int> no_operators;
+        const vector<int> &var_operators =
+            utils::in_bounds(var, operators_by_variable) ?
+            operators_by_variable[var] : no_operators;
+        auto test_bit = [](const vector<uint64_t> &bits, int op_id) {
+                return (bits[op_id / 64] >> (op_id % 64)) & 1;
+            };
+        auto reset_bit = [](vector<uint64_t> &bits, int op_id) {
+                bits[op_id / 64] &= ~(uint64_t(1) << (op_id % 64));
+            };
+        auto set_bit = [](vector<uint64_t> &bits, int op_id) {
+                bits[op_id / 64] |= uint64_t(1) << (op_id % 64);
+            };
+        for (int op_id : var_operators) {
+            reset_bit(v1_bits, op_id);
+        }
+        vector<uint64_t> v2_bits = v1_bits;
+        for (int op_id : var_operators) {
+            if (test_bit(old_bits, op_id)) {
+                rewire_loop(
+                    op_id,
+                    [&](int id) {set_bit(v1_bits, id);},
+                    [&](int id) {set_bit(v2_bits, id);});
             }
         }
+        loops[v1_id].assign(move(v1_bits));
+        loops[v2_id].assign(move(v2_bits));
+    } else {
+        old_loops.for_each(
+            [&](int op_id) {
+                rewire_loop(
+                    op_id,
+                    [&](int id) {v1_loops.push_back(id);},
+                    [&](int id) {v2_loops.push_back(id);});
+            });
+        // Operator IDs are visited in increasing order, so the lists are sorted.
+        loops[v1_id].assign(v1_loops, get_num_operators());
+        loops[v2_id].assign(v2_loops, get_num_operators());
+        v1_loops.clear();
+        v2_loops.clear();
     }
-    num_loops -= old_loops.size();
+    num_loops += loops[v1_id].size() + loops[v2_id].size() - old_loops.size();
 }
 
 void TransitionSystem::rewire(
     const AbstractStates &states, int v_id,
     const AbstractState &v1, const AbstractState &v2, int var) {
     // Retrieve old transitions and make space for new transitions.
-    Transitions old_incoming = move(incoming[v_id]);
-    Transitions old_outgoing = move(outgoing[v_id]);
+    assert(old_incoming.empty() && old_outgoing.empty());
+    incoming.extract_transitions(v_id, old_incoming);
+    outgoing.extract_transitions(v_id, old_outgoing);
     Loops old_loops = move(loops[v_id]);
     enlarge_vectors_by_one();
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
     utils::unused_variable(v1_id);
     utils::unused_variable(v2_id);
-    assert(incoming[v1_id].empty() && outgoing[v1_id].empty() && loops[v1_id].empty());
-    assert(incoming[v2_id].empty() && outgoing[v2_id].empty() && loops[v2_id].empty());
+    assert(incoming.get_num_transitions(v1_id) == 0 &&
+           outgoing.get_num_transitions(v1_id) == 0 && loops[v1_id].empty());
+    assert(incoming.get_num_transitions(v2_id) == 0 &&
+           outgoing.get_num_transitions(v2_id) == 0 && loops[v2_id].empty());
 
     // Remove old transitions and add new transitions.
     rewire_incoming_transitions(old_incoming, states, v1, v2, var);
     rewire_outgoing_transitions(old_outgoing, states, v1, v2, var);
     rewire_loops(old_loops, v1, v2, var);
+    old_incoming.clear();
+    old_outgoing.clear();
 }
 
-const vector<Transitions> &TransitionSystem::get_incoming_transitions() const {
+const TransitionLists &TransitionSystem::get_incoming_transitions() const {
     return incoming;
 }
 
-const vector<Transitions> &TransitionSystem::get_outgoing_transitions() const {
+const TransitionLists &TransitionSystem::get_outgoing_transitions() const {
     return outgoing;
 }
 
-const vector<Loops> &TransitionSystem::get_loops() const {
-    return loops;
-}
-
 int TransitionSystem::get_num_states() const {
-    assert(incoming.size() == outgoing.size());
-    assert(loops.size() == outgoing.size());
-    return outgoing.size();
+    assert(incoming.get_num_states() == outgoing.get_num_states());
+    assert(static_cast<int>(loops.size()) == outgoing.get_num_states());
+    return outgoing.get_num_states();
 }
 
 int TransitionSystem::get_num_operators() const {
@@ -331,8 +421,8 @@ void TransitionSystem::print_statistics(utils::LogProxy &log) const {
         int total_outgoing_transitions = 0;
         int total_loops = 0;
         for (int state_id = 0; state_id < get_num_states(); ++state_id) {
-            total_incoming_transitions += incoming[state_id].size();
-            total_outgoing_transitions += outgoing[state_id].size();
+            total_incoming_transitions += incoming.get_num_transitions(state_id);
+            total_outgoing_transitions += outgoing.get_num_transitions(state_id);
             total_loops += loops[state_id].size();
         }
         assert(total_outgoing_transitions == total_incoming_transitions);
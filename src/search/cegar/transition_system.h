@@ -1,8 +1,13 @@
 #ifndef CEGAR_TRANSITION_SYSTEM_H
 #define CEGAR_TRANSITION_SYSTEM_H
 
+#include "transition_lists.h"
 #include "types.h"
 
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 struct FactPair;
@@ -17,12 +22,81 @@ namespace cegar {
   Rewire transitions after each split.
 */
 class TransitionSystem {
+    /*
+      Operators inducing self-loops in an abstract state. In many tasks,
+      most operators induce self-loops in most abstract states, so we
+      store the operators either as a sorted list of IDs or as a bitset
+      over all operators, whichever needs less memory.
+
+      Self-loops do not count towards the max_transitions limit, which
+      only bounds the number of non-looping transitions stored in
+      incoming and outgoing. The compact storage reduces the memory
+      usage of the abstraction but does not raise this limit.
+    */
+    class Loops {
+        std::vector<int> op_ids;
+        std::vector<uint64_t> op_bits;
+        int num_loops = 0;
+public:
+        Loops() = default;
+        Loops(Loops &&other) noexcept
+            : op_ids(std::move(other.op_ids)),
+              op_bits(std::move(other.op_bits)),
+              num_loops(std::exchange(other.num_loops, 0)) {
+        }
+        Loops &operator=(Loops &&other) noexcept {
+            op_ids = std::move(other.op_ids);
+            op_bits = std::move(other.op_bits);
+            num_loops = std::exchange(other.num_loops, 0);
+            return *this;
+        }
+
+        // Replace the loops by the given sorted operator IDs.
+        void assign(const std::vector<int> &sorted_op_ids, int num_operators);
+        // Replace the loops by the given bitset over all operators.
+        void assign(std::vector<uint64_t> &&bits);
+
+        bool is_bitset() const {
+            return !op_bits.empty();
+        }
+
+        const std::vector<uint64_t> &get_bits() const {
+            assert(is_bitset());
+            return op_bits;
+        }
+
+        template<typename Callback>
+        void for_each(const Callback &callback) const {
+            if (!is_bitset()) {
+                for (int op_id : op_ids) {
+                    callback(op_id);
+                }
+                return;
+            }
+            for (size_t block = 0; block < op_bits.size(); ++block) {
+                uint64_t bits = op_bits[block];
+                while (bits) {
+                    callback(static_cast<int>(block * 64) + std::countr_zero(bits));
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        int size() const {
+            return num_loops;
+        }
+
+        bool empty() const {
+            return num_loops == 0;
+        }
+    };
+
     const std::vector<std::vector<FactPair>> preconditions_by_operator;
     const std::vector<std::vector<FactPair>> postconditions_by_operator;
 
     // Transitions from and to other abstract states.
-    std::vector<Transitions> incoming;
-    std::vector<Transitions> outgoing;
+    TransitionLists incoming;
+    TransitionLists outgoing;
 
     // Store self-loops (operator indices) separately to save space.
     std::vector<Loops> loops;
@@ -30,6 +104,15 @@ class TransitionSystem {
     int num_non_loops;
     int num_loops;
 
+    // Sorted IDs of the operators with a postcondition on each variable.
+    std::vector<std::vector<int>> operators_by_variable;
+
+    // Avoid reallocating the transitions and loops of split states.
+    Transitions old_incoming;
+    Transitions old_outgoing;
+    std::vector<int> v1_loops;
+    std::vector<int> v2_loops;
+
     void enlarge_vectors_by_one();
 
     // Add self-loops to single abstract state in trivial abstraction.
@@ -39,7 +122,6 @@ class TransitionSystem {
     int get_postcondition_value(int op_id, int var) const;
 
     void add_transition(int src_id, int op_id, int target_id);
-    void add_loop(int state_id, int op_id);
 
     void rewire_incoming_transitions(
         const Transitions &old_incoming, const AbstractStates &states,
@@ -59,9 +141,14 @@ public:
         const AbstractStates &states, int v_id,
         const AbstractState &v1, const AbstractState &v2, int var);
 
-    const std::vector<Transitions> &get_incoming_transitions() const;
-    const std::vector<Transitions> &get_outgoing_transitions() const;
-    const std::vector<Loops> &get_loops() const;
+    const TransitionLists &get_incoming_transitions() const;
+    const TransitionLists &get_outgoing_transitions() const;
+
+    // Call callback(op_id) for all operators inducing self-loops in the state.
+    template<typename Callback>
+    void for_each_loop(int state_id, const Callback &callback) const {
+        loops[state_id].for_each(callback);
+    }
 
     int get_num_states() const;
     int get_num_operators() const;
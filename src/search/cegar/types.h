@@ -13,8 +13,9 @@ struct Transition;
 using AbstractStates = std::vector<std::unique_ptr<AbstractState>>;
 using Goals = std::unordered_set<int>;
 using NodeID = int;
-using Loops = std::vector<int>;
 using Transitions = std::vector<Transition>;
+// Bit offsets of the variables in Cartesian sets (see CartesianSet).
+using VarOffsets = std::shared_ptr<const std::vector<int>>;
 
 const int UNDEFINED = -1;
 
@@ -2,6 +2,7 @@
 
 #include "evaluation_result.h"
 #include "evaluator.h"
+#include "search_profiler.h"
 #include "search_statistics.h"
 
 #include <cassert>
@@ -43,16 +44,27 @@ EvaluationContext::EvaluationContext(
 }
 
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
-    EvaluationResult &result = cache[evaluator];
-    if (result.is_uninitialized()) {
-        result = evaluator->compute_result(*this);
-        if (statistics &&
-            evaluator->is_used_for_counting_evaluations() &&
-            result.get_count_evaluation()) {
-            statistics->inc_evaluations();
-        }
+    if (cache.contains(evaluator)) {
+        return cache.get(evaluator);
     }
-    return result;
+    /*
+      We only insert the result after computing it because evaluators
+      may add results of their subevaluators to the cache.
+    */
+    EvaluationResult result = compute_result(evaluator);
+    assert(!result.is_uninitialized());
+    if (statistics &&
+        evaluator->is_used_for_counting_evaluations() &&
+        result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+    return cache.insert(evaluator, move(result));
+}
+
+EvaluationResult EvaluationContext::compute_result(Evaluator *evaluator) {
+    ProfilingScope profiling_scope(
+        statistics ? statistics->get_profiler() : nullptr, evaluator);
+    return evaluator->compute_result(*this);
 }
 
 const EvaluatorCache &EvaluationContext::get_cache() const {
@@ -6,7 +6,6 @@
 #include "operator_id.h"
 #include "task_proxy.h"
 
-#include <unordered_map>
 
 class Evaluator;
 class SearchStatistics;
@@ -54,6 +53,8 @@ class EvaluationContext {
         const EvaluatorCache &cache, const State &state, int g_value,
         bool is_preferred, SearchStatistics *statistics,
         bool calculate_preferred);
+
+    EvaluationResult compute_result(Evaluator *evaluator);
 public:
     /*
       Copy existing heuristic cache and use it to look up heuristic values.
@@ -5,25 +5,47 @@
 #include "utils/system.h"
 
 #include <cassert>
+#include <mutex>
 
 using namespace std;
 
 
+atomic<int> Evaluator::num_evaluators(0);
+atomic<int> Evaluator::num_cache_indices(0);
+
 Evaluator::Evaluator(const plugins::Options &opts,
                      bool use_for_reporting_minima,
                      bool use_for_boosting,
                      bool use_for_counting_evaluations)
-    : description(opts.get_unparsed_config()),
+    : id(num_evaluators++),
+      cache_index(-1),
+      description(opts.get_unparsed_config()),
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
       use_for_counting_evaluations(use_for_counting_evaluations),
       log(utils::get_log_from_options(opts)) {
 }
 
+int Evaluator::assign_cache_index() const {
+    // Lock to give each evaluator exactly one index without gaps.
+    static mutex assignment_mutex;
+    lock_guard<mutex> lock(assignment_mutex);
+    int index = cache_index.load(memory_order_relaxed);
+    if (index == -1) {
+        index = num_cache_indices++;
+        cache_index.store(index, memory_order_relaxed);
+    }
+    return index;
+}
+
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+bool Evaluator::supports_concurrent_evaluation() const {
+    return false;
+}
+
 void Evaluator::report_value_for_initial_state(
     const EvaluationResult &result) const {
     if (log.is_at_least_normal()) {
@@ -5,6 +5,7 @@
 
 #include "utils/logging.h"
 
+#include <atomic>
 #include <set>
 
 class EvaluationContext;
@@ -15,6 +16,12 @@ class Options;
 }
 
 class Evaluator {
+    // Evaluators may be created concurrently while building heuristics.
+    static std::atomic<int> num_evaluators;
+    static std::atomic<int> num_cache_indices;
+
+    const int id;
+    mutable std::atomic<int> cache_index;
     const std::string description;
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
@@ -51,6 +58,17 @@ public:
         std::set<Evaluator *> &evals) = 0;
 
 
+    /*
+      supports_concurrent_evaluation should return true if compute_result
+      may be called concurrently from several threads for different
+      evaluation contexts. This is the case if the evaluator is not
+      path-dependent and does not modify shared data during evaluation
+      (or protects the data it modifies).
+
+      The default implementation returns false.
+    */
+    virtual bool supports_concurrent_evaluation() const;
+
     virtual void notify_initial_state(const State & /*initial_state*/) {
     }
 
@@ -86,6 +104,33 @@ public:
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
+    /*
+      Evaluators are numbered consecutively in the order of their creation.
+      The IDs are used to index per-evaluator data (see SearchProfiler).
+    */
+    int get_id() const {
+        return id;
+    }
+    static int get_num_evaluators() {
+        return num_evaluators;
+    }
+
+    /*
+      Cached evaluation results are indexed by a separate number that an
+      evaluator only gets when its result is cached for the first time
+      (see EvaluatorCache). This keeps the cache small when heuristics
+      create many evaluators for internal use, e.g., the h^add heuristics
+      of the CEGAR split selectors. get_cache_index() returns -1 if the
+      evaluator has no cache index yet.
+    */
+    int get_cache_index() const {
+        return cache_index.load(std::memory_order_relaxed);
+    }
+    int assign_cache_index() const;
+    static int get_num_cache_indices() {
+        return num_cache_indices;
+    }
+
     const std::string &get_description() const;
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
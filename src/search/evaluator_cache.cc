@@ -1,8 +1,65 @@
 #include "evaluator_cache.h"
 
+#include "evaluator.h"
+
+#include <algorithm>
+#include <cassert>
+
 using namespace std;
 
 
-EvaluationResult &EvaluatorCache::operator[](Evaluator *eval) {
-    return eval_results[eval];
+struct CacheStorage {
+    vector<Evaluator *> evaluators;
+    vector<EvaluationResult> results;
+};
+
+// At most this many unused storage objects are kept per thread.
+static const size_t MAX_POOL_SIZE = 8;
+static thread_local vector<CacheStorage> storage_pool;
+
+
+EvaluatorCache::~EvaluatorCache() {
+    if (!evaluators.empty() && storage_pool.size() < MAX_POOL_SIZE) {
+        storage_pool.push_back({move(evaluators), move(results)});
+    }
+}
+
+void EvaluatorCache::allocate(int num_evaluators) {
+    if (evaluators.empty() && !storage_pool.empty()) {
+        CacheStorage &storage = storage_pool.back();
+        evaluators = move(storage.evaluators);
+        results = move(storage.results);
+        storage_pool.pop_back();
+        fill(evaluators.begin(), evaluators.end(), nullptr);
+    }
+    if (num_evaluators > static_cast<int>(evaluators.size())) {
+        evaluators.resize(num_evaluators, nullptr);
+        results.resize(num_evaluators);
+    }
+}
+
+bool EvaluatorCache::contains(const Evaluator *eval) const {
+    int index = eval->get_cache_index();
+    return index != -1 && index < static_cast<int>(evaluators.size()) &&
+           evaluators[index];
+}
+
+const EvaluationResult &EvaluatorCache::get(const Evaluator *eval) const {
+    assert(contains(eval));
+    return results[eval->get_cache_index()];
+}
+
+const EvaluationResult &EvaluatorCache::insert(
+    Evaluator *eval, EvaluationResult &&result) {
+    assert(!contains(eval));
+    int index = eval->get_cache_index();
+    if (index == -1) {
+        index = eval->assign_cache_index();
+    }
+    if (index >= static_cast<int>(evaluators.size())) {
+        allocate(max(index + 1, Evaluator::get_num_cache_indices()));
+    }
+    evaluators[index] = eval;
+    results[index] = move(result);
+    return results[index];
 }
@@ -3,27 +3,53 @@
 
 #include "evaluation_result.h"
 
-#include <unordered_map>
+#include <vector>
 
 class Evaluator;
 
-using EvaluationResults = std::unordered_map<Evaluator *, EvaluationResult>;
-
 /*
   Store evaluation results for evaluators.
+
+  Results are stored in a flat vector indexed by the cache indices of the
+  evaluators (see Evaluator::get_cache_index()). Only evaluators whose
+  results have been cached have a cache index, so the vector does not grow
+  with evaluators that heuristics use internally. The vector "evaluators"
+  serves as the validity mask: evaluators[index] points to the evaluator
+  with the given cache index if its result is cached and is nullptr
+  otherwise.
+
+  The vectors are sized for all cache indices that exist when the first
+  result is inserted, so references to cached results stay valid unless
+  results of further evaluators are cached afterwards.
+
+  Search algorithms create a new cache for every evaluated state. To avoid
+  reallocating the vectors every time, destroyed caches hand their storage
+  to a small per-thread pool from which new caches take it.
 */
 class EvaluatorCache {
-    EvaluationResults eval_results;
+    std::vector<Evaluator *> evaluators;
+    std::vector<EvaluationResult> results;
 
+    void allocate(int num_evaluators);
 public:
-    EvaluationResult &operator[](Evaluator *eval);
+    EvaluatorCache() = default;
+    EvaluatorCache(const EvaluatorCache &other) = default;
+    EvaluatorCache(EvaluatorCache &&other) = default;
+    ~EvaluatorCache();
+    EvaluatorCache &operator=(const EvaluatorCache &other) = default;
+    EvaluatorCache &operator=(EvaluatorCache &&other) = default;
+
+    bool contains(const Evaluator *eval) const;
+    const EvaluationResult &get(const Evaluator *eval) const;
+    const EvaluationResult &insert(Evaluator *eval, EvaluationResult &&result);
 
     template<class Callback>
     void for_each_evaluator_result(const Callback &callback) const {
-        for (const auto &element : eval_results) {
-            const Evaluator *eval = element.first;
-            const EvaluationResult &result = element.second;
-            callback(eval, result);
+        for (size_t id = 0; id < evaluators.size(); ++id) {
+            const Evaluator *eval = evaluators[id];
+            if (eval) {
+                callback(eval, results[id]);
+            }
         }
     }
 };
@@ -24,6 +24,14 @@ bool CombiningEvaluator::dead_ends_are_reliable() const {
     return all_dead_ends_are_reliable;
 }
 
+bool CombiningEvaluator::supports_concurrent_evaluation() const {
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators) {
+        if (!subevaluator->supports_concurrent_evaluation())
+            return false;
+    }
+    return true;
+}
+
 EvaluationResult CombiningEvaluator::compute_result(
     EvaluationContext &eval_context) {
     // This marks no preferred operators.
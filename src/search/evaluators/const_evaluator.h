@@ -19,6 +19,9 @@ public:
     explicit ConstEvaluator(const plugins::Options &opts);
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &) override {}
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
     virtual ~ConstEvaluator() override = default;
 };
 }
@@ -15,6 +15,10 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
     virtual void get_path_dependent_evaluators(std::set<Evaluator *> &) override {}
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
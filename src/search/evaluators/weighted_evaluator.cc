@@ -23,6 +23,10 @@ bool WeightedEvaluator::dead_ends_are_reliable() const {
     return evaluator->dead_ends_are_reliable();
 }
 
+bool WeightedEvaluator::supports_concurrent_evaluation() const {
+    return evaluator->supports_concurrent_evaluation();
+}
+
 EvaluationResult WeightedEvaluator::compute_result(
     EvaluationContext &eval_context) {
     // Note that this produces no preferred operators.
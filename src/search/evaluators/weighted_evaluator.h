@@ -19,6 +19,7 @@ public:
     virtual ~WeightedEvaluator() override;
 
     virtual bool dead_ends_are_reliable() const override;
+    virtual bool supports_concurrent_evaluation() const override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
     virtual void get_path_dependent_evaluators(std::set<Evaluator *> &evals) override;
@@ -14,6 +14,8 @@
 
 using namespace std;
 
+bool Heuristic::concurrent_evaluation_enabled = false;
+
 Heuristic::Heuristic(const plugins::Options &opts)
     : Evaluator(opts, true, true, true),
       heuristic_cache(HEntry(NO_VALUE, true)), //TODO: is true really a good idea here?
@@ -33,6 +35,18 @@ State Heuristic::convert_ancestor_state(const State &ancestor_state) const {
     return task_proxy.convert_ancestor_state(ancestor_state);
 }
 
+unique_lock<mutex> Heuristic::lock_heuristic_cache() {
+    unique_lock<mutex> lock(heuristic_cache_mutex, defer_lock);
+    if (concurrent_evaluation_enabled) {
+        lock.lock();
+    }
+    return lock;
+}
+
+void Heuristic::enable_concurrent_evaluation() {
+    concurrent_evaluation_enabled = true;
+}
+
 void Heuristic::add_options_to_feature(plugins::Feature &feature) {
     add_evaluator_options_to_feature(feature);
     feature.add_option<shared_ptr<AbstractTask>>(
@@ -53,13 +67,18 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 
     int heuristic = NO_VALUE;
 
-    if (!calculate_preferred && cache_evaluator_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
-        heuristic = heuristic_cache[state].h;
-        result.set_count_evaluation(false);
-    } else {
+    if (!calculate_preferred && cache_evaluator_values) {
+        unique_lock<mutex> lock = lock_heuristic_cache();
+        HEntry entry = heuristic_cache[state];
+        if (entry.h != NO_VALUE && !entry.dirty) {
+            heuristic = entry.h;
+            result.set_count_evaluation(false);
+        }
+    }
+    if (heuristic == NO_VALUE) {
         heuristic = compute_heuristic(state);
         if (cache_evaluator_values) {
+            unique_lock<mutex> lock = lock_heuristic_cache();
             heuristic_cache[state] = HEntry(heuristic, false);
         }
         result.set_count_evaluation(true);
@@ -75,7 +94,9 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
           have a dead end, we don't want to actually report any
           preferred operators.
         */
-        preferred_operators.clear();
+        if (!preferred_operators.empty()) {
+            preferred_operators.clear();
+        }
         heuristic = EvaluationResult::INFTY;
     }
 
@@ -89,7 +110,13 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 #endif
 
     result.set_evaluator_value(heuristic);
-    result.set_preferred_operators(preferred_operators.pop_as_vector());
+    /*
+      Heuristics that support concurrent evaluation never set preferred
+      operators, so we only touch the shared set if it is non-empty.
+    */
+    if (!preferred_operators.empty()) {
+        result.set_preferred_operators(preferred_operators.pop_as_vector());
+    }
     assert(preferred_operators.empty());
 
     return result;
@@ -9,6 +9,7 @@
 #include "algorithms/ordered_set.h"
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class TaskProxy;
@@ -53,6 +54,15 @@ protected:
     */
     PerStateInformation<HEntry> heuristic_cache;
     bool cache_evaluator_values;
+    /*
+      Protects heuristic_cache for heuristics that support concurrent
+      evaluation (see Evaluator::supports_concurrent_evaluation). The
+      mutex is only locked while concurrent evaluation is enabled.
+    */
+    std::mutex heuristic_cache_mutex;
+    static bool concurrent_evaluation_enabled;
+
+    std::unique_lock<std::mutex> lock_heuristic_cache();
 
     // Hold a reference to the task implementation and pass it to objects that need it.
     const std::shared_ptr<AbstractTask> task;
@@ -82,6 +92,12 @@ public:
 
     static void add_options_to_feature(plugins::Feature &feature);
 
+    /*
+      Must be called by search engines before they evaluate states
+      concurrently (and while no heuristic is evaluated).
+    */
+    static void enable_concurrent_evaluation();
+
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
 
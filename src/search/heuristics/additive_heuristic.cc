@@ -115,10 +115,27 @@ void AdditiveHeuristic::mark_preferred_operators(
     }
 }
 
+int AdditiveHeuristic::compute_operator_cost(OpID op_id) {
+    int cost = unary_operators[op_id].base_cost;
+    for (PropID precond : get_preconditions(op_id)) {
+        int precond_cost = get_proposition(precond)->cost;
+        if (precond_cost == -1)
+            return -1;
+        increase_cost(cost, precond_cost);
+    }
+    return cost;
+}
+
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (incremental) {
+        for (Proposition &prop : propositions)
+            prop.marked = false;
+        repair_relaxed_exploration(state);
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
@@ -150,7 +167,7 @@ public:
     AdditiveHeuristicFeature() : TypedFeature("add") {
         document_title("Additive heuristic");
 
-        Heuristic::add_options_to_feature(*this);
+        relaxation_heuristic::RelaxationHeuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
         document_language_support("conditional effects", "supported");
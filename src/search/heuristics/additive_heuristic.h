@@ -60,6 +60,7 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     void write_overflow_warning();
 protected:
+    virtual int compute_operator_cost(OpID op_id) override;
     virtual int compute_heuristic(const State &ancestor_state) override;
 
     // Common part of h^add and h^ff computation.
@@ -11,6 +11,10 @@ protected:
 public:
     BlindSearchHeuristic(const plugins::Options &opts);
     ~BlindSearchHeuristic();
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
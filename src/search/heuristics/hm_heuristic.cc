@@ -5,25 +5,54 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <iterator>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+static const int NO_VALUE = -1;
+static const int CONFLICTING_VALUES = -2;
+
+/*
+  Collect all tuples of 1 to max_size of the given facts, which must be
+  sorted, skipping combinations that mention a variable twice.
+*/
+static void collect_partial_tuples(
+    const vector<FactPair> &facts, int max_size, size_t index,
+    vector<FactPair> &tuple, vector<vector<FactPair>> &result) {
+    for (size_t i = index; i < facts.size(); ++i) {
+        if (!tuple.empty() && tuple.back().var == facts[i].var) {
+            continue;
+        }
+        tuple.push_back(facts[i]);
+        result.push_back(tuple);
+        if (static_cast<int>(tuple.size()) < max_size) {
+            collect_partial_tuples(facts, max_size, i + 1, tuple, result);
+        }
+        tuple.pop_back();
+    }
+}
+
 HMHeuristic::HMHeuristic(const plugins::Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      goals(task_properties::get_fact_pairs(task_proxy.get_goals())),
+      ranking(task_proxy.get_variables(), m),
+      hm_table(ranking.get_num_tuples()) {
     if (log.is_at_least_normal()) {
         log << "Using h^" << m << "." << endl;
-        log << "The implementation of the h^m heuristic is preliminary." << endl
-            << "It is SLOOOOOOOOOOOW." << endl
-            << "Please do not use this for comparison!" << endl;
     }
-    generate_all_tuples();
+    sort(goals.begin(), goals.end());
+    compute_operator_infos();
+    if (log.is_at_least_normal()) {
+        log << "Number of h^" << m << " tuples: " << hm_table.size() << endl;
+    }
 }
 
 
@@ -32,6 +61,67 @@ bool HMHeuristic::dead_ends_are_reliable() const {
 }
 
 
+void HMHeuristic::compute_operator_infos() {
+    OperatorsProxy operators = task_proxy.get_operators();
+    operator_infos.reserve(operators.size());
+    operators_by_precondition_fact.resize(ranking.get_num_facts());
+    for (OperatorProxy op : operators) {
+        OperatorInfo info;
+        info.preconditions = task_properties::get_fact_pairs(op.get_preconditions());
+        sort(info.preconditions.begin(), info.preconditions.end());
+        for_each_partial_tuple(info.preconditions, [&](int tuple_id) {
+                                   info.precondition_tuple_ids.push_back(tuple_id);
+                               });
+        for (const FactPair &fact : info.preconditions) {
+            operators_by_precondition_fact[ranking.get_fact_id(fact)].push_back(op.get_id());
+        }
+
+        for (EffectProxy eff : op.get_effects()) {
+            info.effects.push_back(eff.get_fact().get_pair());
+        }
+        sort(info.effects.begin(), info.effects.end());
+        info.effects.erase(unique(info.effects.begin(), info.effects.end()),
+                           info.effects.end());
+        Tuple tuple;
+        collect_partial_tuples(info.effects, m, 0, tuple, info.partial_effects);
+        for (const Tuple &partial_eff : info.partial_effects) {
+            info.partial_effect_ids.push_back(ranking.get_tuple_id(partial_eff));
+        }
+
+        info.cost = op.get_cost();
+        operator_infos.push_back(move(info));
+    }
+    is_open.resize(operators.size(), false);
+    precondition_values.resize(task_proxy.get_variables().size(), NO_VALUE);
+    effect_values.resize(task_proxy.get_variables().size(), NO_VALUE);
+}
+
+
+template<typename Callback>
+void HMHeuristic::for_each_partial_tuple(
+    const Tuple &facts, const Callback &callback) const {
+    for_each_partial_tuple_aux(facts, 0, -1, -1, 0, callback);
+}
+
+
+template<typename Callback>
+void HMHeuristic::for_each_partial_tuple_aux(
+    const Tuple &facts, int index, int tuple_id, int last_var, int size,
+    const Callback &callback) const {
+    for (size_t i = index; i < facts.size(); ++i) {
+        const FactPair &fact = facts[i];
+        assert(fact.var > last_var);
+        int child_id = (size == 0) ? ranking.get_fact_id(fact)
+            : ranking.get_child_id(tuple_id, last_var, fact);
+        callback(child_id);
+        if (size + 1 < m) {
+            for_each_partial_tuple_aux(
+                facts, i + 1, child_id, fact.var, size + 1, callback);
+        }
+    }
+}
+
+
 int HMHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     if (task_properties::is_goal_state(task_proxy, state)) {
@@ -44,7 +134,7 @@ int HMHeuristic::compute_heuristic(const State &ancestor_state) {
 
         int h = eval(goals);
 
-        if (h == numeric_limits<int>::max())
+        if (h == INF)
             return DEAD_END;
         return h;
     }
@@ -52,204 +142,227 @@ int HMHeuristic::compute_heuristic(const State &ancestor_state) {
 
 
 void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
-    }
+    fill(hm_table.begin(), hm_table.end(), INF);
+    for_each_partial_tuple(t, [&](int tuple_id) {
+                               hm_table[tuple_id] = 0;
+                           });
 }
 
 
 void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
-        }
-    } while (was_updated);
+    enqueue_all_operators();
+    while (!open_operators.empty()) {
+        int op_id = open_operators.front();
+        open_operators.pop_front();
+        is_open[op_id] = false;
+        process_operator(op_id);
+    }
 }
 
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
-        }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
-
-            sort(pre.begin(), pre.end());
+void HMHeuristic::enqueue_all_operators() {
+    for (size_t op_id = 0; op_id < operator_infos.size(); ++op_id) {
+        enqueue_operator(op_id);
+    }
+}
 
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
-            }
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
-            }
-        }
+void HMHeuristic::enqueue_operator(int op_id) {
+    if (!is_open[op_id]) {
+        is_open[op_id] = true;
+        open_operators.push_back(op_id);
     }
 }
 
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
+void HMHeuristic::process_operator(int op_id) {
+    const OperatorInfo &op = operator_infos[op_id];
+    int c1 = 0;
+    for (int tuple_id : op.precondition_tuple_ids) {
+        c1 = max(c1, hm_table[tuple_id]);
+    }
+    if (c1 == INF) {
+        return;
+    }
 
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
+    for (const FactPair &fact : op.preconditions) {
+        precondition_values[fact.var] = fact.value;
+    }
+    for (const FactPair &fact : op.effects) {
+        int &value = effect_values[fact.var];
+        value = (value == NO_VALUE) ? fact.value : CONFLICTING_VALUES;
     }
-    return max;
-}
 
+    for (size_t i = 0; i < op.partial_effects.size(); ++i) {
+        const Tuple &partial_eff = op.partial_effects[i];
+        update_hm_entry(partial_eff, op.partial_effect_ids[i], c1 + op.cost);
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+        int eff_size = partial_eff.size();
+        if (eff_size < m) {
+            extend_tuple(partial_eff, op, c1);
+        }
+    }
+
+    for (const FactPair &fact : op.preconditions) {
+        precondition_values[fact.var] = NO_VALUE;
+    }
+    for (const FactPair &fact : op.effects) {
+        effect_values[fact.var] = NO_VALUE;
     }
-    return val;
 }
 
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return numeric_limits<int>::max();
-        }
-    }
-    return 0;
+bool HMHeuristic::contradicts_current_operator(const FactPair &fact) const {
+    int value = effect_values[fact.var];
+    return value != NO_VALUE && value != fact.value;
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+bool HMHeuristic::conflicts_with_current_precondition(const FactPair &fact) const {
+    int value = precondition_values[fact.var];
+    return value != NO_VALUE && value != fact.value;
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+/*
+  Update all tuples t + others, where others are facts of variables not
+  mentioned in t that are not contradicted by the effects of op. The cost
+  of reaching such a tuple with op is the cost of op plus the h^m value of
+  the precondition of op extended by others.
+*/
+void HMHeuristic::extend_tuple(const Tuple &t, const OperatorInfo &op, int c1) {
+    for (const FactPair &fact : t) {
+        if (contradicts_current_operator(fact)) {
+            return;
+        }
     }
-    sort(effects.begin(), effects.end());
-    return effects;
+    Tuple others;
+    extend_tuple_aux(t, op, c1, 0, others);
 }
 
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+void HMHeuristic::extend_tuple_aux(
+    const Tuple &t, const OperatorInfo &op, int c1, int var, Tuple &others) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    for (; var < num_variables; ++var) {
+        bool var_in_t = any_of(t.begin(), t.end(), [var](const FactPair &fact) {
+                                   return fact.var == var;
+                               });
+        if (var_in_t) {
+            continue;
+        }
+        int domain_size = variables[var].get_domain_size();
+        for (int value = 0; value < domain_size; ++value) {
+            FactPair fact(var, value);
+            if (contradicts_current_operator(fact) ||
+                conflicts_with_current_precondition(fact)) {
+                continue;
+            }
+            others.push_back(fact);
+
+            extended_tuple.clear();
+            merge(t.begin(), t.end(), others.begin(), others.end(),
+                  back_inserter(extended_tuple));
+            extension.clear();
+            for (const FactPair &other : others) {
+                if (precondition_values[other.var] == NO_VALUE) {
+                    extension.push_back(other);
+                }
+            }
+            int c2 = c1;
+            if (!extension.empty()) {
+                c2 = max(c2, eval_extended_precondition(op.preconditions));
+            }
+            if (c2 != INF) {
+                update_hm_entry(extended_tuple, ranking.get_tuple_id(extended_tuple),
+                                c2 + op.cost);
+            }
+
+            if (static_cast<int>(t.size() + others.size()) < m) {
+                extend_tuple_aux(t, op, c1, var + 1, others);
+            }
+            others.pop_back();
         }
     }
-    return false;
 }
 
 
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+/*
+  Return the maximum h^m value of all tuples of pre + extension that
+  contain at least one fact of the extension.
+*/
+int HMHeuristic::eval_extended_precondition(const Tuple &pre) {
+    extended_precondition.clear();
+    is_extension_fact.clear();
+    auto pre_it = pre.begin();
+    auto ext_it = extension.begin();
+    while (pre_it != pre.end() || ext_it != extension.end()) {
+        if (ext_it == extension.end() ||
+            (pre_it != pre.end() && pre_it->var < ext_it->var)) {
+            extended_precondition.push_back(*pre_it++);
+            is_extension_fact.push_back(false);
+        } else {
+            extended_precondition.push_back(*ext_it++);
+            is_extension_fact.push_back(true);
+        }
+    }
+    int result = 0;
+    eval_extended_precondition_aux(0, -1, -1, 0, false, result);
+    return result;
 }
 
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
-            }
+void HMHeuristic::eval_extended_precondition_aux(
+    int index, int tuple_id, int last_var, int size,
+    bool contains_extension_fact, int &result) const {
+    for (size_t i = index; i < extended_precondition.size(); ++i) {
+        bool contains = contains_extension_fact || is_extension_fact[i];
+        if (!contains && size + 1 == m) {
+            continue;
+        }
+        const FactPair &fact = extended_precondition[i];
+        int child_id = (size == 0) ? ranking.get_fact_id(fact)
+            : ranking.get_child_id(tuple_id, last_var, fact);
+        if (contains) {
+            result = max(result, hm_table[child_id]);
+        }
+        if (size + 1 < m) {
+            eval_extended_precondition_aux(
+                i + 1, child_id, fact.var, size + 1, contains, result);
         }
     }
 }
 
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
+int HMHeuristic::eval(const Tuple &t) const {
+    int max = 0;
+    for_each_partial_tuple(t, [&](int tuple_id) {
+                               int h = hm_table[tuple_id];
+                               if (h > max) {
+                                   max = h;
+                               }
+                           });
+    return max;
 }
 
 
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+/*
+  Tuples of size m can only occur in the (extended) preconditions of
+  operators with a precondition in the tuple. Smaller tuples can extend
+  the precondition of every operator.
+*/
+void HMHeuristic::update_hm_entry(const Tuple &t, int tuple_id, int val) {
+    if (hm_table[tuple_id] > val) {
+        hm_table[tuple_id] = val;
+        if (static_cast<int>(t.size()) < m) {
+            enqueue_all_operators();
+        } else {
+            for (const FactPair &fact : t) {
+                for (int op_id : operators_by_precondition_fact[ranking.get_fact_id(fact)]) {
+                    enqueue_operator(op_id);
+                }
+            }
         }
     }
 }
@@ -257,9 +370,22 @@ void HMHeuristic::generate_all_partial_tuples_aux(
 
 void HMHeuristic::dump_table() const {
     if (log.is_at_least_debug()) {
-        for (auto &hm_ent : hm_table) {
-            log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
-        }
+        VariablesProxy variables = task_proxy.get_variables();
+        Tuple tuple;
+        function<void(int)> dump = [&](int var) {
+                for (; var < static_cast<int>(variables.size()); ++var) {
+                    for (int value = 0; value < variables[var].get_domain_size(); ++value) {
+                        tuple.emplace_back(var, value);
+                        log << "h(" << tuple << ") = "
+                            << hm_table[ranking.get_tuple_id(tuple)] << endl;
+                        if (static_cast<int>(tuple.size()) < m) {
+                            dump(var + 1);
+                        }
+                        tuple.pop_back();
+                    }
+                }
+            };
+        dump(0);
     }
 }
 
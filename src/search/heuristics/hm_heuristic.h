@@ -3,10 +3,9 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include "../task_utils/fact_tuple_ranking.h"
+
+#include <deque>
 #include <vector>
 
 namespace plugins {
@@ -17,43 +16,95 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  The h^m table contains one entry for each tuple of 1 to m facts over
+  pairwise different variables. We only consider tuples whose facts are
+  sorted by variable and index the table with their IDs in a
+  FactTupleRanking.
+
+  The table is computed with a worklist fixpoint. Whenever an entry
+  decreases, we reconsider all operators whose precondition or extended
+  preconditions contain a fact of the updated tuple.
 */
 
 class HMHeuristic : public Heuristic {
     using Tuple = std::vector<FactPair>;
+
+    struct OperatorInfo {
+        Tuple preconditions;
+        // IDs of all tuples of at most m preconditions.
+        std::vector<int> precondition_tuple_ids;
+        // All tuples of at most m effects and their IDs.
+        std::vector<Tuple> partial_effects;
+        std::vector<int> partial_effect_ids;
+        Tuple effects;
+        int cost;
+    };
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
+    Tuple goals;
+
+    fact_tuple_ranking::FactTupleRanking ranking;
 
     // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
+    std::vector<int> hm_table;
+
+    std::vector<OperatorInfo> operator_infos;
+    std::vector<std::vector<int>> operators_by_precondition_fact;
+
+    // Worklist of operators that have to be (re)considered.
+    std::deque<int> open_operators;
+    std::vector<bool> is_open;
+
+    /*
+      Values of the preconditions and effects of the operator that is
+      currently processed (NO_VALUE if there is none and
+      CONFLICTING_VALUES if there are effects with different values).
+    */
+    std::vector<int> precondition_values;
+    std::vector<int> effect_values;
+
+    // Buffers for extending tuples.
+    Tuple extended_tuple;
+    Tuple extension;
+    Tuple extended_precondition;
+    std::vector<bool> is_extension_fact;
+
+    void compute_operator_infos();
+
+    /*
+      Call callback(tuple_id) for all tuples of 1 to m of the given facts,
+      which must be sorted by variable and mention each variable at most
+      once.
+    */
+    template<typename Callback>
+    void for_each_partial_tuple(const Tuple &facts, const Callback &callback) const;
+    template<typename Callback>
+    void for_each_partial_tuple_aux(
+        const Tuple &facts, int index, int tuple_id, int last_var, int size,
+        const Callback &callback) const;
 
     // auxiliary methods
     void init_hm_table(const Tuple &t);
     void update_hm_table();
+    void process_operator(int op_id);
     int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
+    int eval_extended_precondition(const Tuple &pre);
+    void eval_extended_precondition_aux(
+        int index, int tuple_id, int last_var, int size,
+        bool contains_extension_fact, int &result) const;
+    void update_hm_entry(const Tuple &t, int tuple_id, int val);
+    void extend_tuple(const Tuple &t, const OperatorInfo &op, int c1);
+    void extend_tuple_aux(
+        const Tuple &t, const OperatorInfo &op, int c1, int var,
+        Tuple &others);
+    void enqueue_all_operators();
+    void enqueue_operator(int op_id);
+
+    bool contradicts_current_operator(const FactPair &fact) const;
+    bool conflicts_with_current_precondition(const FactPair &fact) const;
 
     void dump_table() const;
 
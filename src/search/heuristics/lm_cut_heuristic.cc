@@ -15,23 +15,46 @@ using namespace std;
 
 namespace lm_cut_heuristic {
 LandmarkCutHeuristic::LandmarkCutHeuristic(const plugins::Options &opts)
-    : Heuristic(opts),
-      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)) {
+    : Heuristic(opts) {
     if (log.is_at_least_normal()) {
         log << "Initializing landmark cut heuristic..." << endl;
     }
+    unused_landmark_generators.push_back(
+        utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy));
 }
 
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
 }
 
+unique_ptr<LandmarkCutLandmarks> LandmarkCutHeuristic::acquire_landmark_generator() {
+    {
+        lock_guard<mutex> lock(landmark_generators_mutex);
+        if (!unused_landmark_generators.empty()) {
+            unique_ptr<LandmarkCutLandmarks> landmark_generator =
+                move(unused_landmark_generators.back());
+            unused_landmark_generators.pop_back();
+            return landmark_generator;
+        }
+    }
+    return utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy);
+}
+
+void LandmarkCutHeuristic::release_landmark_generator(
+    unique_ptr<LandmarkCutLandmarks> landmark_generator) {
+    lock_guard<mutex> lock(landmark_generators_mutex);
+    unused_landmark_generators.push_back(move(landmark_generator));
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int total_cost = 0;
+    unique_ptr<LandmarkCutLandmarks> landmark_generator =
+        acquire_landmark_generator();
     bool dead_end = landmark_generator->compute_landmarks(
         state,
         [&total_cost](int cut_cost) {total_cost += cut_cost;},
         nullptr);
+    release_landmark_generator(move(landmark_generator));
 
     if (dead_end)
         return DEAD_END;
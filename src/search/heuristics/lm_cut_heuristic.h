@@ -4,6 +4,8 @@
 #include "../heuristic.h"
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace plugins {
 class Options;
@@ -13,12 +15,27 @@ namespace lm_cut_heuristic {
 class LandmarkCutLandmarks;
 
 class LandmarkCutHeuristic : public Heuristic {
-    std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
+    /*
+      LandmarkCutLandmarks stores the state of the ongoing computation, so
+      each concurrent evaluation needs its own instance. Unused instances
+      are kept here and only created on demand, so without concurrent
+      evaluation there is exactly one instance.
+    */
+    std::vector<std::unique_ptr<LandmarkCutLandmarks>> unused_landmark_generators;
+    std::mutex landmark_generators_mutex;
+
+    std::unique_ptr<LandmarkCutLandmarks> acquire_landmark_generator();
+    void release_landmark_generator(
+        std::unique_ptr<LandmarkCutLandmarks> landmark_generator);
 
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit LandmarkCutHeuristic(const plugins::Options &opts);
     virtual ~LandmarkCutHeuristic() override;
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
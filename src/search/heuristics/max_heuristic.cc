@@ -80,12 +80,28 @@ void HSPMaxHeuristic::relaxed_exploration() {
     }
 }
 
+int HSPMaxHeuristic::compute_operator_cost(OpID op_id) {
+    const UnaryOperator &unary_op = unary_operators[op_id];
+    int cost = unary_op.base_cost;
+    for (PropID precond : get_preconditions(op_id)) {
+        int precond_cost = get_proposition(precond)->cost;
+        if (precond_cost == -1)
+            return -1;
+        cost = max(cost, unary_op.base_cost + precond_cost);
+    }
+    return cost;
+}
+
 int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
 
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (incremental) {
+        repair_relaxed_exploration(state);
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
@@ -103,7 +119,7 @@ public:
     HSPMaxHeuristicFeature() : TypedFeature("hmax") {
         document_title("Max heuristic");
 
-        Heuristic::add_options_to_feature(*this);
+        relaxation_heuristic::RelaxationHeuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
         document_language_support("conditional effects", "supported");
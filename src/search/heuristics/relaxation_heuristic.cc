@@ -1,5 +1,6 @@
 #include "relaxation_heuristic.h"
 
+#include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
@@ -36,7 +37,8 @@ UnaryOperator::UnaryOperator(
 
 // construction and destruction
 RelaxationHeuristic::RelaxationHeuristic(const plugins::Options &opts)
-    : Heuristic(opts) {
+    : Heuristic(opts),
+      incremental(opts.get<bool>("incremental")) {
     // Build propositions.
     propositions.resize(task_properties::get_num_facts(task_proxy));
 
@@ -90,6 +92,22 @@ RelaxationHeuristic::RelaxationHeuristic(const plugins::Options &opts)
             precondition_of_pool.append(precondition_of_vec);
         propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
     }
+
+    if (incremental) {
+        compute_achievers();
+    }
+}
+
+void RelaxationHeuristic::add_options_to_feature(plugins::Feature &feature) {
+    Heuristic::add_options_to_feature(feature);
+    feature.add_option<bool>(
+        "incremental",
+        "repair the relaxed exploration of the previously evaluated state "
+        "instead of starting from scratch. This pays off when consecutively "
+        "evaluated states are similar, e.g., siblings in eager search. "
+        "Heuristic values are the same, but best achievers may be chosen "
+        "differently, which can change preferred operators and relaxed plans",
+        "false");
 }
 
 bool RelaxationHeuristic::dead_ends_are_reliable() const {
@@ -117,6 +135,149 @@ Proposition *RelaxationHeuristic::get_proposition(const FactProxy &fact) {
     return get_proposition(fact.get_variable().get_id(), fact.get_value());
 }
 
+void RelaxationHeuristic::compute_achievers() {
+    vector<vector<OpID>> achievers_vectors(propositions.size());
+    int num_unary_ops = unary_operators.size();
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        achievers_vectors[unary_operators[op_id].effect].push_back(op_id);
+    }
+    achievers.reserve(propositions.size());
+    num_achievers.reserve(propositions.size());
+    for (const vector<OpID> &achievers_vector : achievers_vectors) {
+        achievers.push_back(achievers_pool.append(achievers_vector));
+        num_achievers.push_back(achievers_vector.size());
+    }
+}
+
+void RelaxationHeuristic::enqueue_if_cheaper(PropID prop_id, int cost, OpID op_id) {
+    assert(cost >= 0);
+    Proposition &prop = propositions[prop_id];
+    if (prop.cost == -1 || prop.cost > cost) {
+        prop.cost = cost;
+        prop.reached_by = op_id;
+        incremental_queue.push(cost, prop_id);
+    }
+}
+
+/*
+  Collect all propositions whose best achiever transitively depends on
+  one of the given propositions (including these propositions) and
+  reset their costs.
+*/
+void RelaxationHeuristic::collect_affected_propositions(
+    const vector<PropID> &removed_props) {
+    affected_propositions.clear();
+    for (PropID prop_id : removed_props) {
+        Proposition &prop = propositions[prop_id];
+        prop.cost = -1;
+        prop.reached_by = NO_OP;
+        affected_propositions.push_back(prop_id);
+    }
+    // Reset propositions have no best achiever, so they are never added twice.
+    for (size_t i = 0; i < affected_propositions.size(); ++i) {
+        const Proposition &prop = propositions[affected_propositions[i]];
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop.precondition_of, prop.num_precondition_occurences)) {
+            PropID effect_id = unary_operators[op_id].effect;
+            Proposition &effect = propositions[effect_id];
+            if (effect.reached_by == op_id) {
+                effect.cost = -1;
+                effect.reached_by = NO_OP;
+                affected_propositions.push_back(effect_id);
+            }
+        }
+    }
+}
+
+void RelaxationHeuristic::repair_relaxed_exploration(const State &state) {
+    assert(incremental);
+    incremental_queue.clear();
+    vector<PropID> removed_props;
+    vector<PropID> added_props;
+    if (previous_state_values.empty()) {
+        /*
+          Start from the labelling for a state without any facts, where
+          only the effects of operators without preconditions are reached.
+          Other propositions are reached from the facts of the state below.
+        */
+        for (Proposition &prop : propositions) {
+            prop.cost = -1;
+            prop.reached_by = NO_OP;
+        }
+        int num_unary_ops = unary_operators.size();
+        for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+            const UnaryOperator &op = unary_operators[op_id];
+            if (op.num_preconditions == 0) {
+                enqueue_if_cheaper(op.effect, op.base_cost, op_id);
+            }
+        }
+        previous_state_values.assign(state.size(), -1);
+    }
+    for (FactProxy fact : state) {
+        int var = fact.get_variable().get_id();
+        int value = fact.get_value();
+        int old_value = previous_state_values[var];
+        if (value != old_value) {
+            if (old_value != -1) {
+                PropID old_prop = get_prop_id(var, old_value);
+                removed_props.push_back(old_prop);
+            }
+            PropID new_prop = get_prop_id(var, value);
+            added_props.push_back(new_prop);
+            previous_state_values[var] = value;
+        }
+    }
+
+    /*
+      Recompute the costs of the affected propositions from their
+      achievers. All affected propositions must be reset before, since
+      otherwise they could support each other.
+    */
+    collect_affected_propositions(removed_props);
+    vector<pair<int, OpID>> best_achievers;
+    best_achievers.reserve(affected_propositions.size());
+    for (PropID prop_id : affected_propositions) {
+        pair<int, OpID> best(-1, NO_OP);
+        for (OpID op_id : achievers_pool.get_slice(
+                 achievers[prop_id], num_achievers[prop_id])) {
+            int cost = compute_operator_cost(op_id);
+            if (cost != -1 && (best.first == -1 || cost < best.first)) {
+                best = make_pair(cost, op_id);
+            }
+        }
+        best_achievers.push_back(best);
+    }
+    for (size_t i = 0; i < affected_propositions.size(); ++i) {
+        if (best_achievers[i].first != -1) {
+            enqueue_if_cheaper(affected_propositions[i],
+                               best_achievers[i].first, best_achievers[i].second);
+        }
+    }
+    for (PropID prop_id : added_props) {
+        Proposition &prop = propositions[prop_id];
+        prop.cost = 0;
+        prop.reached_by = NO_OP;
+        incremental_queue.push(0, prop_id);
+    }
+
+    // Propagate cost decreases.
+    while (!incremental_queue.empty()) {
+        pair<int, PropID> top_pair = incremental_queue.pop();
+        int distance = top_pair.first;
+        const Proposition &prop = propositions[top_pair.second];
+        assert(prop.cost != -1 && prop.cost <= distance);
+        if (prop.cost < distance)
+            continue;
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop.precondition_of, prop.num_precondition_occurences)) {
+            int cost = compute_operator_cost(op_id);
+            if (cost != -1) {
+                enqueue_if_cheaper(unary_operators[op_id].effect, cost, op_id);
+            }
+        }
+    }
+}
+
 void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
     int op_no = op.is_axiom() ? -1 : op.get_id();
     int base_cost = op.get_cost();
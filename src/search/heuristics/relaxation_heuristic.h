@@ -5,6 +5,7 @@
 
 #include "../heuristic.h"
 
+#include "../algorithms/priority_queues.h"
 #include "../utils/collections.h"
 
 #include <cassert>
@@ -13,6 +14,10 @@
 class FactProxy;
 class OperatorProxy;
 
+namespace plugins {
+class Feature;
+}
+
 namespace relaxation_heuristic {
 struct Proposition;
 struct UnaryOperator;
@@ -60,7 +65,26 @@ class RelaxationHeuristic : public Heuristic {
 
     // proposition_offsets[var_no]: first PropID related to variable var_no
     std::vector<PropID> proposition_offsets;
+
+    /*
+      Data for the incremental exploration, which repairs the cost
+      labelling of the previously evaluated state instead of computing
+      it from scratch.
+    */
+    array_pool::ArrayPool achievers_pool;
+    std::vector<array_pool::ArrayPoolIndex> achievers;
+    std::vector<int> num_achievers;
+    // Empty before the first incremental exploration.
+    std::vector<int> previous_state_values;
+    std::vector<PropID> affected_propositions;
+    priority_queues::AdaptiveQueue<PropID> incremental_queue;
+
+    void compute_achievers();
+    void collect_affected_propositions(const std::vector<PropID> &removed_props);
+    void enqueue_if_cheaper(PropID prop_id, int cost, OpID op_id);
 protected:
+    const bool incremental;
+
     std::vector<UnaryOperator> unary_operators;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
@@ -109,9 +133,31 @@ protected:
     const Proposition *get_proposition(int var, int value) const;
     Proposition *get_proposition(int var, int value);
     Proposition *get_proposition(const FactProxy &fact);
+
+    /*
+      Return the cost of the given unary operator based on the current
+      costs of its preconditions (including its base cost) or -1 if a
+      precondition is unreached.
+    */
+    virtual int compute_operator_cost(OpID op_id) = 0;
+
+    /*
+      Compute the costs and best achievers (reached_by) of all
+      propositions for the given state. Unlike the explorations of the
+      derived classes, this does not stop once all goals are reached.
+      Instead, it keeps the labelling of all propositions and repairs it
+      for the next state: propositions whose best achiever depends on
+      facts that are no longer true are reset and recomputed, and cost
+      decreases are propagated Dijkstra-style from the new facts. The
+      resulting costs match a full exploration, but ties between best
+      achievers may be broken differently.
+    */
+    void repair_relaxed_exploration(const State &state);
 public:
     explicit RelaxationHeuristic(const plugins::Options &options);
 
+    static void add_options_to_feature(plugins::Feature &feature);
+
     virtual bool dead_ends_are_reliable() const override;
 };
 }
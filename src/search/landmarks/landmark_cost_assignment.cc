@@ -9,6 +9,7 @@
 #include "../utils/language.h"
 
 #include <algorithm>
+#include <bit>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
@@ -139,16 +140,24 @@ double LandmarkUniformSharedCostAssignment::cost_sharing_h_value(
 
 LandmarkEfficientOptimalSharedCostAssignment::LandmarkEfficientOptimalSharedCostAssignment(
     const vector<int> &operator_costs, const LandmarkGraph &graph,
-    lp::LPSolverType solver_type)
+    lp::LPSolverType solver_type, int lp_cache_size, double lp_time_limit)
     : LandmarkCostAssignment(operator_costs, graph),
       lp_solver(solver_type),
-      lp(build_initial_lp()) {
+      active_columns((2 * graph.get_num_landmarks() + 63) / 64, 0),
+      previous_active_columns(active_columns.size(), 0),
+      lp_cache_size(lp_cache_size),
+      fallback_cost_assignment(operator_costs, graph, true) {
+    lp_solver.load_problem(build_initial_lp());
+    if (lp_time_limit != numeric_limits<double>::infinity()) {
+        lp_solver.set_time_limit(lp_time_limit);
+    }
 }
 
 lp::LinearProgram LandmarkEfficientOptimalSharedCostAssignment::build_initial_lp() {
-    /* The LP has one variable (column) per landmark and one
-       inequality (row) per operator. */
-    int num_cols = lm_graph.get_num_landmarks();
+    /* The LP has two variables (columns) per landmark (see header) and
+       one inequality (row) per operator. */
+    int num_landmarks = lm_graph.get_num_landmarks();
+    int num_cols = 2 * num_landmarks;
     int num_rows = operator_costs.size();
 
     named_vector::NamedVector<lp::LPVariable> lp_variables;
@@ -161,16 +170,40 @@ lp::LinearProgram LandmarkEfficientOptimalSharedCostAssignment::build_initial_lp
     /* Set up lower bounds and upper bounds for the inequalities.
        These simply say that the operator's total cost must fall
        between 0 and the real operator cost. */
-    lp_constraints.resize(num_rows, lp::LPConstraint(0.0, 0.0));
-    for (size_t op_id = 0; op_id < operator_costs.size(); ++op_id) {
-        lp_constraints[op_id].set_lower_bound(0);
-        lp_constraints[op_id].set_upper_bound(operator_costs[op_id]);
+    vector<lp::LPConstraint> constraints_by_op(num_rows, lp::LPConstraint(0.0, 0.0));
+    for (int op_id = 0; op_id < num_rows; ++op_id) {
+        constraints_by_op[op_id].set_upper_bound(operator_costs[op_id]);
+    }
+
+    /*
+      Define the constraint matrix. The constraints are of the form
+      cost(lm_i1) + cost(lm_i2) + ... + cost(lm_in) <= cost(o)
+      where lm_i1 ... lm_in are the columns for which o is a relevant
+      achiever: a first achiever for the columns of landmarks that are
+      not reached and a possible achiever for the columns of landmarks
+      that are needed again.
+    */
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        const Landmark &landmark = lm_graph.get_node(lm_id)->get_landmark();
+        for (int op_id : get_achievers(lm_not_reached, landmark)) {
+            assert(utils::in_bounds(op_id, constraints_by_op));
+            constraints_by_op[op_id].insert(lm_id, 1.0);
+        }
+        for (int op_id : get_achievers(lm_needed_again, landmark)) {
+            assert(utils::in_bounds(op_id, constraints_by_op));
+            constraints_by_op[op_id].insert(num_landmarks + lm_id, 1.0);
+        }
+    }
+
+    // Operators that achieve no landmark do not constrain the LP. See issue443.
+    named_vector::NamedVector<lp::LPConstraint> lp_constraints;
+    for (lp::LPConstraint &constraint : constraints_by_op) {
+        if (!constraint.empty())
+            lp_constraints.push_back(move(constraint));
     }
 
-    /* Coefficients of constraints will be updated and recreated in each state.
-       We ignore them for the initial LP. */
     return lp::LinearProgram(lp::LPObjectiveSense::MAXIMIZE, move(lp_variables),
-                             {}, lp_solver.get_infinity());
+                             move(lp_constraints), lp_solver.get_infinity());
 }
 
 double LandmarkEfficientOptimalSharedCostAssignment::cost_sharing_h_value(
@@ -179,65 +212,59 @@ double LandmarkEfficientOptimalSharedCostAssignment::cost_sharing_h_value(
              do in the uniform cost partitioning case. */
 
     /*
-      Set up LP variable bounds for the landmarks.
-      The range of cost(lm_1) is {0} if the landmark is already
-      reached; otherwise it is [0, infinity].
-      The lower bounds are set to 0 in the constructor and never change.
+      Determine the active columns. The range of cost(lm_i) is {0} if
+      the landmark is already reached; otherwise it is [0, infinity] for
+      the column matching the status of the landmark.
     */
-    int num_cols = lm_graph.get_num_landmarks();
-    for (int lm_id = 0; lm_id < num_cols; ++lm_id) {
-        if (lm_status_manager.get_landmark_status(lm_id) == lm_reached) {
-            lp.get_variables()[lm_id].upper_bound = 0;
-        } else {
-            lp.get_variables()[lm_id].upper_bound = lp_solver.get_infinity();
-        }
-    }
-
-    /*
-      Define the constraint matrix. The constraints are of the form
-      cost(lm_i1) + cost(lm_i2) + ... + cost(lm_in) <= cost(o)
-      where lm_i1 ... lm_in are the landmarks for which o is a
-      relevant achiever. Hence, we add a triple (op, lm, 1.0)
-      for each relevant achiever op of landmark lm, denoting that
-      in the op-th row and lm-th column, the matrix has a 1.0 entry.
-    */
-    // Reuse previous constraint objects to save the effort of recreating them.
-    for (lp::LPConstraint &constraint : lp_constraints) {
-        constraint.clear();
-    }
-    for (int lm_id = 0; lm_id < num_cols; ++lm_id) {
-        const Landmark &landmark = lm_graph.get_node(lm_id)->get_landmark();
+    int num_landmarks = lm_graph.get_num_landmarks();
+    fill(active_columns.begin(), active_columns.end(), 0);
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
         int lm_status = lm_status_manager.get_landmark_status(lm_id);
         if (lm_status != lm_reached) {
-            const set<int> &achievers =
-                get_achievers(lm_status, landmark);
-            if (achievers.empty())
+            const Landmark &landmark = lm_graph.get_node(lm_id)->get_landmark();
+            if (get_achievers(lm_status, landmark).empty())
                 return numeric_limits<double>::max();
-            for (int op_id : achievers) {
-                assert(utils::in_bounds(op_id, lp_constraints));
-                lp_constraints[op_id].insert(lm_id, 1.0);
-            }
+            int col = (lm_status == lm_not_reached) ? lm_id : num_landmarks + lm_id;
+            active_columns[col / 64] |= uint64_t(1) << (col % 64);
         }
     }
 
-    /* Copy non-empty constraints and use those in the LP.
-       This significantly speeds up the heuristic calculation. See issue443. */
-    // TODO: do not copy the data here.
-    lp.get_constraints().clear();
-    for (const lp::LPConstraint &constraint : lp_constraints) {
-        if (!constraint.empty())
-            lp.get_constraints().push_back(constraint);
+    if (lp_cache_size > 0) {
+        auto it = lp_cache.find(active_columns);
+        if (it != lp_cache.end()) {
+            return it->second;
+        }
     }
 
-    // Load the problem into the LP solver.
-    lp_solver.load_problem(lp);
+    // Only update the bounds of columns that changed since the last LP.
+    for (size_t block = 0; block < active_columns.size(); ++block) {
+        uint64_t changed = active_columns[block] ^ previous_active_columns[block];
+        while (changed) {
+            int bit = countr_zero(changed);
+            changed &= changed - 1;
+            int col = block * 64 + bit;
+            bool is_active = (active_columns[block] >> bit) & 1;
+            lp_solver.set_variable_upper_bound(
+                col, is_active ? lp_solver.get_infinity() : 0);
+        }
+        previous_active_columns[block] = active_columns[block];
+    }
 
-    // Solve the linear program.
+    // Solve the linear program, starting from the previous basis.
     lp_solver.solve();
 
-    assert(lp_solver.has_optimal_solution());
+    if (!lp_solver.has_optimal_solution()) {
+        // The solver exceeded its time limit.
+        return fallback_cost_assignment.cost_sharing_h_value(lm_status_manager);
+    }
     double h = lp_solver.get_objective_value();
 
+    if (lp_cache_size > 0) {
+        if (static_cast<int>(lp_cache.size()) >= lp_cache_size) {
+            lp_cache.clear();
+        }
+        lp_cache.emplace(active_columns, h);
+    }
     return h;
 }
 }
@@ -2,7 +2,9 @@
 #define LANDMARKS_LANDMARK_COST_ASSIGNMENT_H
 
 #include "../lp/lp_solver.h"
+#include "../utils/hash.h"
 
+#include <cstdint>
 #include <set>
 #include <vector>
 
@@ -44,22 +46,35 @@ public:
 
 class LandmarkEfficientOptimalSharedCostAssignment : public LandmarkCostAssignment {
     lp::LPSolver lp_solver;
-    // We keep an additional copy of the constraints around to avoid some effort with recreating the vector (see issue443).
-    std::vector<lp::LPConstraint> lp_constraints;
     /*
-      We keep the vectors for LP variables and constraints around instead of
-      recreating them for every state. The actual constraints have to be
-      recreated because the coefficient matrix of the LP changes from state to
-      state. Reusing the vectors still saves some dynamic allocation overhead.
-     */
-    lp::LinearProgram lp;
+      The LP has two columns per landmark: column i is used if landmark i
+      is not reached and column num_landmarks + i if it is needed again.
+      The two columns have different relevant achievers, so the
+      coefficient matrix is the same for all states and only the column
+      bounds change. This allows the solver to start from the optimal
+      basis of the previous state.
+
+      The bitsets store which columns are active (i.e., are not fixed to
+      0) in the current and previous LP.
+    */
+    std::vector<uint64_t> active_columns;
+    std::vector<uint64_t> previous_active_columns;
+
+    // Map from active columns to LP objective values.
+    const int lp_cache_size;
+    utils::HashMap<std::vector<uint64_t>, double> lp_cache;
+
+    // Admissible estimate for states whose LP exceeds the time limit.
+    LandmarkUniformSharedCostAssignment fallback_cost_assignment;
 
     lp::LinearProgram build_initial_lp();
 public:
     LandmarkEfficientOptimalSharedCostAssignment(
         const std::vector<int> &operator_costs,
         const LandmarkGraph &graph,
-        lp::LPSolverType solver_type);
+        lp::LPSolverType solver_type,
+        int lp_cache_size,
+        double lp_time_limit);
 
     virtual double cost_sharing_h_value(
         const LandmarkStatusManager &lm_status_manager) override;
@@ -55,7 +55,9 @@ void LandmarkCostPartitioningHeuristic::set_cost_assignment(
         lm_cost_assignment =
             utils::make_unique_ptr<LandmarkEfficientOptimalSharedCostAssignment>(
                 task_properties::get_operator_costs(task_proxy),
-                *lm_graph, opts.get<lp::LPSolverType>("lpsolver"));
+                *lm_graph, opts.get<lp::LPSolverType>("lpsolver"),
+                opts.get<int>("lp_cache_size"),
+                opts.get<double>("lp_time_limit"));
     } else {
         lm_cost_assignment =
             utils::make_unique_ptr<LandmarkUniformSharedCostAssignment>(
@@ -114,6 +116,22 @@ public:
             "false");
         add_option<bool>("alm", "use action landmarks", "true");
         lp::add_lp_solver_option_to_feature(*this);
+        add_option<int>(
+            "lp_cache_size",
+            "maximum number of LP results (indexed by the statuses of all "
+            "landmarks) that are cached for ``optimal=true``. The cache is "
+            "cleared when it is full. Use 0 to disable caching.",
+            "0",
+            plugins::Bounds("0", "infinity"));
+        add_option<double>(
+            "lp_time_limit",
+            "time limit in seconds for solving a single LP for "
+            "``optimal=true``. If the LP solver hits the limit, the heuristic "
+            "value of the state is computed with uniform cost partitioning "
+            "and action landmarks instead. Only supported for CPLEX; "
+            "ignored for other LP solvers.",
+            "infinity",
+            plugins::Bounds("0.0", "infinity"));
 
         document_note(
             "Usage with A*",
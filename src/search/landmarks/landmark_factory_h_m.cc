@@ -9,6 +9,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 #include "../utils/system.h"
 
 using namespace std;
@@ -467,6 +468,19 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
 
     VariablesProxy variables = task_proxy.get_variables();
 
+    // collect all sets with size *<* m in the order of FluentSetComparer
+    vector<int> small_set_indices;
+    for (size_t i = 0; i < h_m_table_.size(); ++i) {
+        if (static_cast<int>(h_m_table_[i].fluents.size()) < m_) {
+            small_set_indices.push_back(i);
+        }
+    }
+    sort(small_set_indices.begin(), small_set_indices.end(),
+         [&](int index1, int index2) {
+             return FluentSetComparer()(h_m_table_[index1].fluents,
+                                        h_m_table_[index2].fluents);
+         });
+
     // transfer ops from original problem
     // represent noops as "conditional" effects
     for (OperatorProxy op : operators) {
@@ -485,8 +499,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         unsat_pc_count_[op.get_id()].first = pc_subsets.size();
 
         for (const FluentSet &pc_subset : pc_subsets) {
-            assert(set_indices_.find(pc_subset) != set_indices_.end());
-            set_index = set_indices_[pc_subset];
+            set_index = get_set_index(pc_subset);
             pm_op.pc.push_back(set_index);
             h_m_table_[set_index].pc_for.emplace_back(op.get_id(), -1);
         }
@@ -497,8 +510,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         pm_op.eff.reserve(eff_subsets.size());
 
         for (const FluentSet &eff_subset : eff_subsets) {
-            assert(set_indices_.find(eff_subset) != set_indices_.end());
-            set_index = set_indices_[eff_subset];
+            set_index = get_set_index(eff_subset);
             pm_op.eff.push_back(set_index);
         }
 
@@ -508,10 +520,9 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         // they conflict with the effect of the operator (no need to check pc
         // because mvvs appearing in pc also appear in effect
 
-        FluentSetToIntMap::const_iterator it = set_indices_.begin();
-        while (static_cast<int>(it->first.size()) < m_
-               && it != set_indices_.end()) {
-            if (possible_noop_set(variables, eff, it->first)) {
+        for (int small_set_index : small_set_indices) {
+            const FluentSet &small_set = h_m_table_[small_set_index].fluents;
+            if (possible_noop_set(variables, eff, small_set)) {
                 // for each such set, add a "conditional effect" to the operator
                 pm_op.cond_noops.resize(pm_op.cond_noops.size() + 1);
 
@@ -523,8 +534,8 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // get the subsets that have >= 1 element in the pc (unless pc is empty)
                 // and >= 1 element in the other set
 
-                get_split_m_sets(variables, m_, noop_pc_subsets, pc, it->first);
-                get_split_m_sets(variables, m_, noop_eff_subsets, eff, it->first);
+                get_split_m_sets(variables, m_, noop_pc_subsets, pc, small_set);
+                get_split_m_sets(variables, m_, noop_eff_subsets, eff, small_set);
 
                 this_cond_noop.reserve(noop_pc_subsets.size() + noop_eff_subsets.size() + 1);
 
@@ -533,9 +544,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // push back all noop preconditions
                 for (size_t j = 0; j < noop_pc_subsets.size(); ++j) {
                     assert(static_cast<int>(noop_pc_subsets[j].size()) <= m_);
-                    assert(set_indices_.find(noop_pc_subsets[j]) != set_indices_.end());
-
-                    set_index = set_indices_[noop_pc_subsets[j]];
+                    set_index = get_set_index(noop_pc_subsets[j]);
                     this_cond_noop.push_back(set_index);
                     // these facts are "conditional pcs" for this action
                     h_m_table_[set_index].pc_for.emplace_back(op.get_id(), noop_index);
@@ -547,20 +556,23 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // and the noop effects
                 for (size_t j = 0; j < noop_eff_subsets.size(); ++j) {
                     assert(static_cast<int>(noop_eff_subsets[j].size()) <= m_);
-                    assert(set_indices_.find(noop_eff_subsets[j]) != set_indices_.end());
-
-                    set_index = set_indices_[noop_eff_subsets[j]];
+                    set_index = get_set_index(noop_eff_subsets[j]);
                     this_cond_noop.push_back(set_index);
                 }
 
                 ++noop_index;
             }
-            ++it;
         }
         print_pm_op(variables, pm_op);
     }
 }
 
+int LandmarkFactoryHM::get_set_index(const FluentSet &fs) const {
+    int set_index = set_indices_[ranking_->get_tuple_id(fs)];
+    assert(set_index != -1);
+    return set_index;
+}
+
 bool LandmarkFactoryHM::interesting(const VariablesProxy &variables,
                                     const FactPair &fact1, const FactPair &fact2) const {
     // mutexes can always be safely pruned
@@ -583,14 +595,19 @@ void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
         cerr << "h^m landmarks don't support axioms" << endl;
         utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
     }
+    VariablesProxy variables = task_proxy.get_variables();
+    ranking_ = utils::make_unique_ptr<fact_tuple_ranking::FactTupleRanking>(
+        variables, m_);
+
     // Get all the m or less size subsets in the domain.
     vector<vector<FactPair>> msets;
-    get_m_sets(task_proxy.get_variables(), m_, msets);
+    get_m_sets(variables, m_, msets);
 
     // map each set to an integer
+    set_indices_.assign(ranking_->get_num_tuples(), -1);
     for (size_t i = 0; i < msets.size(); ++i) {
         h_m_table_.emplace_back();
-        set_indices_[msets[i]] = i;
+        set_indices_[ranking_->get_tuple_id(msets[i])] = i;
         h_m_table_[i].fluents = msets[i];
     }
     if (log.is_at_least_normal()) {
@@ -689,7 +706,8 @@ void LandmarkFactoryHM::free_unneeded_memory() {
     utils::release_vector_memory(pm_ops_);
     utils::release_vector_memory(unsat_pc_count_);
 
-    set_indices_.clear();
+    ranking_ = nullptr;
+    utils::release_vector_memory(set_indices_);
     lm_node_table_.clear();
 }
 
@@ -739,7 +757,7 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
 
     // for all of the initial state <= m subsets, mark level = 0
     for (size_t i = 0; i < init_subsets.size(); ++i) {
-        int index = set_indices_[init_subsets[i]];
+        int index = get_set_index(init_subsets[i]);
         h_m_table_[index].level = 0;
 
         // set actions to be applied
@@ -947,9 +965,7 @@ void LandmarkFactoryHM::generate_landmarks(
     get_m_sets(variables, m_, goal_subsets, goals);
     list<int> all_lms;
     for (const FluentSet &goal_subset : goal_subsets) {
-        assert(set_indices_.find(goal_subset) != set_indices_.end());
-
-        int set_index = set_indices_[goal_subset];
+        int set_index = get_set_index(goal_subset);
 
         if (h_m_table_[set_index].level == -1) {
             if (log.is_at_least_verbose()) {
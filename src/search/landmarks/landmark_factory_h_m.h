@@ -3,6 +3,8 @@
 
 #include "landmark_factory.h"
 
+#include "../task_utils/fact_tuple_ranking.h"
+
 namespace landmarks {
 using FluentSet = std::vector<FactPair>;
 
@@ -54,8 +56,6 @@ struct HMEntry {
     }
 };
 
-using FluentSetToIntMap = std::map<FluentSet, int, FluentSetComparer>;
-
 class LandmarkFactoryHM : public LandmarkFactory {
     using TriggerSet = std::unordered_map<int, std::set<int>>;
 
@@ -87,6 +87,8 @@ class LandmarkFactoryHM : public LandmarkFactory {
 
     void add_lm_node(int set_index, bool goal = false);
 
+    int get_set_index(const FluentSet &fs) const;
+
     void initialize(const TaskProxy &task_proxy);
     void free_unneeded_memory();
 
@@ -101,8 +103,9 @@ class LandmarkFactoryHM : public LandmarkFactory {
 
     std::vector<HMEntry> h_m_table_;
     std::vector<PMOp> pm_ops_;
-    // maps each <m set to an int
-    FluentSetToIntMap set_indices_;
+    std::unique_ptr<fact_tuple_ranking::FactTupleRanking> ranking_;
+    // maps the tuple ID of each set in h_m_table_ to its index, -1 for other tuples
+    std::vector<int> set_indices_;
     // first is unsat pcs for operator
     // second is unsat pcs for conditional noops
     std::vector<std::pair<int, std::vector<int>>> unsat_pc_count_;
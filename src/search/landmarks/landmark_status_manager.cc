@@ -4,6 +4,9 @@
 
 #include "../utils/logging.h"
 
+#include <algorithm>
+#include <bit>
+
 using namespace std;
 
 namespace landmarks {
@@ -14,7 +17,83 @@ namespace landmarks {
 LandmarkStatusManager::LandmarkStatusManager(LandmarkGraph &graph)
     : lm_graph(graph),
       reached_lms(vector<bool>(graph.get_num_landmarks(), true)),
-      lm_status(graph.get_num_landmarks(), lm_not_reached) {
+      lm_status(graph.get_num_landmarks(), lm_not_reached),
+      num_landmark_facts(graph.get_num_landmarks(), 0),
+      num_true_landmark_facts(graph.get_num_landmarks(), 0),
+      parent_ids(graph.get_num_landmarks()),
+      greedy_necessary_children_ids(graph.get_num_landmarks()),
+      goal_landmarks(BitsetMath::compute_num_blocks(graph.get_num_landmarks()), 0),
+      true_landmarks(goal_landmarks.size(), 0) {
+    for (auto &lm_node : lm_graph.get_nodes()) {
+        int id = lm_node->get_id();
+        const Landmark &landmark = lm_node->get_landmark();
+        bool any_fact = landmark.disjunctive || landmark.facts.size() == 1;
+        auto &landmarks_by_fact = any_fact ?
+            any_fact_landmarks_by_fact : all_facts_landmarks_by_fact;
+        for (const FactPair &fact : landmark.facts) {
+            if (fact.var >= static_cast<int>(landmarks_by_fact.size())) {
+                landmarks_by_fact.resize(fact.var + 1);
+            }
+            vector<vector<int>> &landmarks_by_value = landmarks_by_fact[fact.var];
+            if (fact.value >= static_cast<int>(landmarks_by_value.size())) {
+                landmarks_by_value.resize(fact.value + 1);
+            }
+            landmarks_by_value[fact.value].push_back(id);
+        }
+        num_landmark_facts[id] = landmark.facts.size();
+
+        if (landmark.is_true_in_goal) {
+            goal_landmarks[BitsetMath::block_index(id)] |= BitsetMath::bit_mask(id);
+        }
+        for (const auto &parent : lm_node->parents) {
+            parent_ids[id].push_back(parent.first->get_id());
+        }
+        for (const auto &child : lm_node->children) {
+            if (child.second >= EdgeType::GREEDY_NECESSARY) {
+                greedy_necessary_children_ids[id].push_back(child.first->get_id());
+            }
+        }
+    }
+}
+
+void LandmarkStatusManager::compute_true_landmarks(const State &state) {
+    fill(true_landmarks.begin(), true_landmarks.end(), 0);
+    auto mark_true = [&](int id) {
+            true_landmarks[BitsetMath::block_index(id)] |= BitsetMath::bit_mask(id);
+        };
+    int num_any_vars = any_fact_landmarks_by_fact.size();
+    int num_all_vars = all_facts_landmarks_by_fact.size();
+    int num_vars = max(num_any_vars, num_all_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        int value = state[var].get_value();
+        if (var < num_any_vars) {
+            const vector<vector<int>> &landmarks_by_value =
+                any_fact_landmarks_by_fact[var];
+            if (value < static_cast<int>(landmarks_by_value.size())) {
+                for (int id : landmarks_by_value[value]) {
+                    mark_true(id);
+                }
+            }
+        }
+        if (var < num_all_vars) {
+            const vector<vector<int>> &landmarks_by_value =
+                all_facts_landmarks_by_fact[var];
+            if (value < static_cast<int>(landmarks_by_value.size())) {
+                for (int id : landmarks_by_value[value]) {
+                    if (num_true_landmark_facts[id]++ == 0) {
+                        touched_landmarks.push_back(id);
+                    }
+                    if (num_true_landmark_facts[id] == num_landmark_facts[id]) {
+                        mark_true(id);
+                    }
+                }
+            }
+        }
+    }
+    for (int id : touched_landmarks) {
+        num_true_landmark_facts[id] = 0;
+    }
+    touched_landmarks.clear();
 }
 
 BitsetView LandmarkStatusManager::get_reached_landmarks(const State &state) {
@@ -83,9 +162,8 @@ bool LandmarkStatusManager::process_state_transition(
     const BitsetView parent_reached = get_reached_landmarks(parent_ancestor_state);
     BitsetView reached = get_reached_landmarks(ancestor_state);
 
-    int num_landmarks = lm_graph.get_num_landmarks();
-    assert(reached.size() == num_landmarks);
-    assert(parent_reached.size() == num_landmarks);
+    assert(reached.size() == lm_graph.get_num_landmarks());
+    assert(parent_reached.size() == lm_graph.get_num_landmarks());
 
     /*
        Set all landmarks not reached by this parent as "not reached".
@@ -100,14 +178,19 @@ bool LandmarkStatusManager::process_state_transition(
     reached.intersect(parent_reached);
 
 
-    // Mark landmarks reached right now as "reached" (if they are "leaves").
-    for (int id = 0; id < num_landmarks; ++id) {
-        if (!reached.test(id)) {
-            LandmarkNode *node = lm_graph.get_node(id);
-            if (node->get_landmark().is_true_in_state(ancestor_state)) {
-                if (landmark_is_leaf(*node, reached)) {
-                    reached.set(id);
-                }
+    /*
+      Mark landmarks reached right now as "reached" (if they are "leaves").
+      Only landmarks that are not reached but true in the state can change,
+      so we look at these block by block in order of increasing IDs.
+    */
+    compute_true_landmarks(ancestor_state);
+    for (int block = 0; block < reached.get_num_blocks(); ++block) {
+        BitsetMath::Block candidates = ~reached.get_block(block) & true_landmarks[block];
+        while (candidates) {
+            int id = block * BitsetMath::bits_per_block + countr_zero(candidates);
+            candidates &= candidates - 1;
+            if (landmark_is_leaf(id, reached)) {
+                reached.set(id);
             }
         }
     }
@@ -124,45 +207,42 @@ void LandmarkStatusManager::update_lm_status(const State &ancestor_state) {
     for (int id = 0; id < num_landmarks; ++id) {
         lm_status[id] = reached.test(id) ? lm_reached : lm_not_reached;
     }
-    for (int id = 0; id < num_landmarks; ++id) {
-        if (lm_status[id] == lm_reached
-            && landmark_needed_again(id, ancestor_state)) {
-            lm_status[id] = lm_needed_again;
+    /* Reached landmarks that are true in the state are not needed again.
+       Reached goal landmarks that are false in the state are. */
+    compute_true_landmarks(ancestor_state);
+    for (int block = 0; block < reached.get_num_blocks(); ++block) {
+        BitsetMath::Block candidates = reached.get_block(block) & ~true_landmarks[block];
+        while (candidates) {
+            int id = block * BitsetMath::bits_per_block + countr_zero(candidates);
+            candidates &= candidates - 1;
+            if ((goal_landmarks[block] & BitsetMath::bit_mask(id)) ||
+                landmark_needed_again(id)) {
+                lm_status[id] = lm_needed_again;
+            }
         }
     }
 }
 
-bool LandmarkStatusManager::landmark_needed_again(
-    int id, const State &state) {
-    LandmarkNode *node = lm_graph.get_node(id);
-    const Landmark &landmark = node->get_landmark();
-    if (landmark.is_true_in_state(state)) {
-        return false;
-    } else if (landmark.is_true_in_goal) {
-        return true;
-    } else {
-        /*
-          For all A ->_gn B, if B is not reached and A currently not
-          true, since A is a necessary precondition for actions
-          achieving B for the first time, it must become true again.
-        */
-        for (const auto &child : node->children) {
-            if (child.second >= EdgeType::GREEDY_NECESSARY
-                && lm_status[child.first->get_id()] == lm_not_reached) {
-                return true;
-            }
+/*
+  For all A ->_gn B, if B is not reached and A currently not true, since
+  A is a necessary precondition for actions achieving B for the first
+  time, it must become true again.
+*/
+bool LandmarkStatusManager::landmark_needed_again(int id) const {
+    for (int child_id : greedy_necessary_children_ids[id]) {
+        if (lm_status[child_id] == lm_not_reached) {
+            return true;
         }
-        return false;
     }
+    return false;
 }
 
-bool LandmarkStatusManager::landmark_is_leaf(const LandmarkNode &node,
-                                             const BitsetView &reached) const {
+bool LandmarkStatusManager::landmark_is_leaf(
+    int id, const BitsetView &reached) const {
     //Note: this is the same as !check_node_orders_disobeyed
-    for (const auto &parent : node.parents) {
-        LandmarkNode *parent_node = parent.first;
+    for (int parent_id : parent_ids[id]) {
         // Note: no condition on edge type here
-        if (!reached.test(parent_node->get_id())) {
+        if (!reached.test(parent_id)) {
             return false;
         }
     }
@@ -17,8 +17,28 @@ class LandmarkStatusManager {
     PerStateBitset reached_lms;
     std::vector<landmark_status> lm_status;
 
-    bool landmark_is_leaf(const LandmarkNode &node, const BitsetView &reached) const;
-    bool landmark_needed_again(int id, const State &state);
+    /*
+      Landmarks are true in a state if one of their facts holds
+      (disjunctive and simple landmarks) or if all of their facts hold
+      (conjunctive landmarks). For both kinds, we store the IDs of the
+      landmarks containing each fact, indexed by variable and value.
+    */
+    std::vector<std::vector<std::vector<int>>> any_fact_landmarks_by_fact;
+    std::vector<std::vector<std::vector<int>>> all_facts_landmarks_by_fact;
+    std::vector<int> num_landmark_facts;
+    std::vector<int> num_true_landmark_facts;
+    std::vector<int> touched_landmarks;
+
+    std::vector<std::vector<int>> parent_ids;
+    std::vector<std::vector<int>> greedy_necessary_children_ids;
+    std::vector<BitsetMath::Block> goal_landmarks;
+
+    // Bitset of the landmarks true in the last state passed to compute_true_landmarks().
+    std::vector<BitsetMath::Block> true_landmarks;
+
+    void compute_true_landmarks(const State &state);
+    bool landmark_is_leaf(int id, const BitsetView &reached) const;
+    bool landmark_needed_again(int id) const;
 
     void set_reached_landmarks_for_initial_state(
         const State &initial_state, utils::LogProxy &log);
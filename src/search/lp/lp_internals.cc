@@ -171,6 +171,19 @@ void set_mip_gap(OsiSolverInterface *lp_solver, double relative_gap) {
 #endif
 }
 
+void set_time_limit(OsiSolverInterface *lp_solver, double seconds) {
+#ifdef COIN_HAS_CPX
+    auto *cpx_solver = dynamic_cast<OsiCpxSolverInterface *>(lp_solver);
+    if (cpx_solver) {
+        CPXsetdblparam(cpx_solver->getEnvironmentPtr(),
+                       CPXPARAM_TimeLimit, seconds);
+    }
+#else
+    utils::unused_variable(lp_solver);
+    utils::unused_variable(seconds);
+#endif
+}
+
 NO_RETURN
 void handle_coin_error(const CoinError &error) {
     if (error.message().find(COIN_CPLEX_ERROR_OOM) != string::npos) {
@@ -31,6 +31,14 @@ std::unique_ptr<OsiSolverInterface> create_lp_solver(LPSolverType solver_type);
 */
 extern void set_mip_gap(OsiSolverInterface *lp_solver, double relative_gap);
 
+/*
+  Limit the time (in seconds) spent in a single call of initialSolve() or
+  resolve(). OSI has no solver-independent time limit, so this currently
+  only has an effect for CPLEX. If the limit is hit, the LP does not have
+  an optimal solution.
+*/
+extern void set_time_limit(OsiSolverInterface *lp_solver, double seconds);
+
 /*
   Print the CoinError and then exit with ExitCode::SEARCH_CRITICAL_ERROR.
   Note that out-of-memory conditions occurring within CPLEX code cannot
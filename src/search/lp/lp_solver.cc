@@ -387,6 +387,10 @@ void LPSolver::set_mip_gap(double gap) {
     lp::set_mip_gap(lp_solver.get(), gap);
 }
 
+void LPSolver::set_time_limit(double seconds) {
+    lp::set_time_limit(lp_solver.get(), seconds);
+}
+
 void LPSolver::solve() {
     try {
         if (is_initialized) {
@@ -163,6 +163,8 @@ public:
     LP_METHOD(void set_variable_upper_bound(int index, double bound))
 
     LP_METHOD(void set_mip_gap(double gap))
+    // See lp_internals.h for which solvers support time limits.
+    LP_METHOD(void set_time_limit(double seconds))
 
     LP_METHOD(void solve())
     LP_METHOD(void write_lp(const std::string &filename) const)
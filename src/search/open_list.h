@@ -123,6 +123,18 @@ public:
     virtual bool is_dead_end(EvaluationContext &eval_context) const = 0;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const = 0;
+
+    /*
+      Return true if all evaluators used by this open list support
+      concurrent evaluation (see Evaluator::supports_concurrent_evaluation).
+      In this case, is_dead_end and is_reliable_dead_end may be called
+      concurrently for different evaluation contexts.
+
+      The default implementation returns false.
+    */
+    virtual bool supports_concurrent_evaluation() const {
+        return false;
+    }
 };
 
 
@@ -34,6 +34,7 @@ public:
     virtual void boost_preferred() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual bool supports_concurrent_evaluation() const override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -104,6 +105,15 @@ void AlternationOpenList<Entry>::get_path_dependent_evaluators(
         sublist->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+bool AlternationOpenList<Entry>::supports_concurrent_evaluation() const {
+    for (const auto &sublist : open_lists) {
+        if (!sublist->supports_concurrent_evaluation())
+            return false;
+    }
+    return true;
+}
+
 template<class Entry>
 bool AlternationOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
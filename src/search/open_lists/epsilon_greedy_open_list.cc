@@ -54,6 +54,7 @@ public:
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool supports_concurrent_evaluation() const override;
     virtual bool empty() const override;
     virtual void clear() override;
 };
@@ -123,6 +124,11 @@ void EpsilonGreedyOpenList<Entry>::get_path_dependent_evaluators(
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+bool EpsilonGreedyOpenList<Entry>::supports_concurrent_evaluation() const {
+    return evaluator->supports_concurrent_evaluation();
+}
+
 template<class Entry>
 bool EpsilonGreedyOpenList<Entry>::empty() const {
     return size == 0;
@@ -44,6 +44,7 @@ public:
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool supports_concurrent_evaluation() const override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -108,6 +109,15 @@ void TieBreakingOpenList<Entry>::get_path_dependent_evaluators(
         evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+bool TieBreakingOpenList<Entry>::supports_concurrent_evaluation() const {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        if (!evaluator->supports_concurrent_evaluation())
+            return false;
+    }
+    return true;
+}
+
 template<class Entry>
 bool TieBreakingOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
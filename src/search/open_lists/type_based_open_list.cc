@@ -43,6 +43,7 @@ public:
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool supports_concurrent_evaluation() const override;
 };
 
 template<class Entry>
@@ -134,6 +135,15 @@ void TypeBasedOpenList<Entry>::get_path_dependent_evaluators(
     }
 }
 
+template<class Entry>
+bool TypeBasedOpenList<Entry>::supports_concurrent_evaluation() const {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        if (!evaluator->supports_concurrent_evaluation())
+            return false;
+    }
+    return true;
+}
+
 TypeBasedOpenListFactory::TypeBasedOpenListFactory(
     const plugins::Options &options)
     : options(options) {
@@ -4,41 +4,168 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <numeric>
+#include <tuple>
 
 using namespace std;
 
 namespace pdbs {
+static const int UNKNOWN_H = -1;
+
+/*
+  PDB values of the state that is currently evaluated. The buffer is
+  shared by all CanonicalPDBs objects of a thread, so evaluating a state
+  does not allocate memory (after the first evaluation) and states can be
+  evaluated concurrently.
+*/
+static thread_local vector<int> h_value_buffer;
+
+// Bounds are summed up with 64 bits and capped to avoid overflows.
+static int cap_h_bound(int64_t bound) {
+    return static_cast<int>(min<int64_t>(bound, numeric_limits<int>::max()));
+}
+
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pdbs,
     const shared_ptr<vector<PatternClique>> &pattern_cliques)
-    : pdbs(pdbs), pattern_cliques(pattern_cliques) {
+    : pdbs(pdbs),
+      has_uniform_storage(true),
+      storage(DistanceStorage::TABLE) {
     assert(pdbs);
     assert(pattern_cliques);
+
+    int num_pdbs = pdbs->size();
+    vector<int> max_h_values(num_pdbs);
+    for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+        const PatternDatabase &pdb = *(*pdbs)[pdb_index];
+        if (pdb_index == 0) {
+            storage = pdb.get_distance_storage();
+        } else if (pdb.get_distance_storage() != storage) {
+            has_uniform_storage = false;
+        }
+        max_h_values[pdb_index] = pdb.get_max_finite_h();
+        if (pdb.has_dead_ends()) {
+            dead_end_pdbs.push_back(pdb_index);
+        }
+    }
+
+    vector<int> num_cliques_by_pdb(num_pdbs, 0);
+    for (const PatternClique &clique : *pattern_cliques) {
+        for (PatternID pdb_index : clique) {
+            ++num_cliques_by_pdb[pdb_index];
+        }
+    }
+
+    vector<PatternClique> cliques = *pattern_cliques;
+    for (PatternClique &clique : cliques) {
+        sort(clique.begin(), clique.end(),
+             [&](PatternID pdb1, PatternID pdb2) {
+                 return make_tuple(-num_cliques_by_pdb[pdb1], -max_h_values[pdb1], pdb1) <
+                 make_tuple(-num_cliques_by_pdb[pdb2], -max_h_values[pdb2], pdb2);
+             });
+    }
+
+    vector<int> clique_h_bounds;
+    clique_h_bounds.reserve(cliques.size());
+    for (const PatternClique &clique : cliques) {
+        int64_t bound = 0;
+        for (PatternID pdb_index : clique) {
+            bound += max_h_values[pdb_index];
+        }
+        clique_h_bounds.push_back(cap_h_bound(bound));
+    }
+    vector<int> clique_order(cliques.size());
+    iota(clique_order.begin(), clique_order.end(), 0);
+    stable_sort(clique_order.begin(), clique_order.end(),
+                [&](int clique1, int clique2) {
+                    return clique_h_bounds[clique1] > clique_h_bounds[clique2];
+                });
+
+    clique_offsets.reserve(cliques.size() + 1);
+    clique_offsets.push_back(0);
+    for (int clique_index : clique_order) {
+        const PatternClique &clique = cliques[clique_index];
+        clique_members.insert(clique_members.end(), clique.begin(), clique.end());
+        remaining_h_bounds.resize(clique_members.size());
+        int64_t bound = 0;
+        for (int i = clique.size() - 1; i >= 0; --i) {
+            bound += max_h_values[clique[i]];
+            remaining_h_bounds[clique_offsets.back() + i] =
+                cap_h_bound(bound);
+        }
+        clique_offsets.push_back(clique_members.size());
+    }
 }
 
-int CanonicalPDBs::get_value(const State &state) const {
+template<typename LookupFunction>
+int CanonicalPDBs::compute_value(const LookupFunction &get_pdb_value) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
-    assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
-    state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
+    assert(clique_offsets.size() > 1);
+    vector<int> &h_values = h_value_buffer;
+    h_values.assign(pdbs->size(), UNKNOWN_H);
+    for (int pdb_index : dead_end_pdbs) {
+        int h = get_pdb_value(*(*pdbs)[pdb_index]);
         if (h == numeric_limits<int>::max()) {
             return numeric_limits<int>::max();
         }
-        h_values.push_back(h);
+        h_values[pdb_index] = h;
     }
-    for (const PatternClique &clique : *pattern_cliques) {
+
+    int max_h = 0;
+    int num_cliques = clique_offsets.size() - 1;
+    for (int clique_index = 0; clique_index < num_cliques; ++clique_index) {
+        int begin = clique_offsets[clique_index];
+        int end = clique_offsets[clique_index + 1];
+        if (begin == end || remaining_h_bounds[begin] <= max_h) {
+            // Cliques are ordered by their bounds, so no clique can do better.
+            break;
+        }
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        for (int i = begin; i < end; ++i) {
+            if (remaining_h_bounds[i] <= max_h - clique_h) {
+                break;
+            }
+            int pdb_index = clique_members[i];
+            int h = h_values[pdb_index];
+            if (h == UNKNOWN_H) {
+                h = get_pdb_value(*(*pdbs)[pdb_index]);
+                h_values[pdb_index] = h;
+            }
+            clique_h += h;
         }
         max_h = max(max_h, clique_h);
     }
     return max_h;
 }
+
+int CanonicalPDBs::get_value(const State &state) const {
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    if (!has_uniform_storage) {
+        return compute_value(
+            [&](const PatternDatabase &pdb) {return pdb.get_value(values);});
+    }
+    switch (storage) {
+    case DistanceStorage::TABLE:
+        return compute_value(
+            [&](const PatternDatabase &pdb) {
+                return pdb.get_value<DistanceStorage::TABLE>(values);
+            });
+    case DistanceStorage::UNCOMPRESSED_TABLE:
+        return compute_value(
+            [&](const PatternDatabase &pdb) {
+                return pdb.get_value<DistanceStorage::UNCOMPRESSED_TABLE>(values);
+            });
+    case DistanceStorage::DIAGRAM:
+        return compute_value(
+            [&](const PatternDatabase &pdb) {
+                return pdb.get_value<DistanceStorage::DIAGRAM>(values);
+            });
+    }
+    assert(false);
+    return 0;
+}
 }
@@ -4,14 +4,51 @@
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
 class State;
 
 namespace pdbs {
+/*
+  The canonical heuristic is the maximum over all pattern cliques of the
+  sum of the PDB values in the clique. We compile the pattern cliques
+  into flat arrays so that the heuristic can be evaluated without
+  allocations and with as few PDB lookups as possible:
+
+  - PDBs that contain dead-ends are always looked up first, because a
+    dead-end in any PDB makes the heuristic infinite.
+  - All other PDB values are only looked up when a clique needs them.
+  - The members of each clique are ordered by the number of cliques they
+    belong to (so values that are needed by many cliques are looked up
+    first). The cliques are ordered by the maximal value they can reach.
+  - We stop summing up a clique as soon as the partial sum plus the
+    maximal value of the remaining PDBs cannot exceed the current
+    maximum, and we stop altogether if this holds for the next clique.
+  - If all PDBs store their distances in the same way, we dispatch on
+    the storage once per state instead of once per lookup.
+*/
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
-    std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
 
+    // Indices of the PDBs that contain dead-ends.
+    std::vector<int> dead_end_pdbs;
+
+    /*
+      The members of the i-th clique are clique_members[j] for
+      clique_offsets[i] <= j < clique_offsets[i + 1]. remaining_h_bounds[j]
+      is an upper bound on the sum of the h-values of clique_members[j]
+      and the members after it in the same clique.
+    */
+    std::vector<int> clique_offsets;
+    std::vector<int> clique_members;
+    std::vector<int> remaining_h_bounds;
+
+    bool has_uniform_storage;
+    // Only meaningful if has_uniform_storage is true.
+    DistanceStorage storage;
+
+    template<typename LookupFunction>
+    int compute_value(const LookupFunction &get_pdb_value) const;
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
@@ -1,7 +1,9 @@
 #include "canonical_pdbs_heuristic.h"
 
 #include "dominance_pruning.h"
+#include "pattern_database.h"
 #include "pattern_generator.h"
+#include "symbolic_pdb_factory.h"
 #include "utils.h"
 
 #include "../plugins/plugin.h"
@@ -27,6 +29,27 @@ CanonicalPDBs get_canonical_pdbs_from_options(
         pattern_generator->generate(task);
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
+    if (opts.get<PDBRepresentation>("representation") == PDBRepresentation::SYMBOLIC) {
+        /*
+          Generators such as systematic or manual_patterns only compute
+          patterns, so we can build the symbolic PDBs instead of explicit
+          ones. If the generator already built explicit PDBs, rebuilding
+          them would only cost time, so we keep them.
+        */
+        if (pattern_collection_info.has_pdbs()) {
+            if (log.is_warning()) {
+                log << "Warning: the pattern generator already computed "
+                    << "explicit PDBs, ignoring representation=symbolic" << endl;
+            }
+        } else {
+            shared_ptr<PDBCollection> symbolic_pdbs = make_shared<PDBCollection>();
+            for (const Pattern &pattern : *patterns) {
+                symbolic_pdbs->push_back(
+                    compute_symbolic_pdb(TaskProxy(*task), pattern));
+            }
+            pattern_collection_info.set_pdbs(symbolic_pdbs);
+        }
+    }
     /*
       We compute PDBs and pattern cliques here (if they have not been
       computed before) so that their computation is not taken into account
@@ -57,6 +80,12 @@ CanonicalPDBs get_canonical_pdbs_from_options(
             log);
     }
 
+    if (!opts.get<bool>("compress_distances")) {
+        for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+            pdb->uncompress_distances();
+        }
+    }
+
     dump_pattern_collection_generation_statistics(
         "Canonical PDB heuristic", timer(), pattern_collection_info, log);
     return CanonicalPDBs(pdbs, pattern_cliques);
@@ -86,6 +115,7 @@ void add_canonical_pdbs_options_to_feature(plugins::Feature &feature) {
         "value because there are dominating subsets in the collection.",
         "infinity",
         plugins::Bounds("0.0", "infinity"));
+    add_distance_compression_option_to_feature(feature);
 }
 
 class CanonicalPDBsHeuristicFeature : public plugins::TypedFeature<Evaluator, CanonicalPDBsHeuristic> {
@@ -106,6 +136,7 @@ public:
             "pattern generation method",
             "systematic(1)");
         add_canonical_pdbs_options_to_feature(*this);
+        add_pdb_representation_option_to_feature(*this);
         Heuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
@@ -20,6 +20,10 @@ protected:
 public:
     explicit CanonicalPDBsHeuristic(const plugins::Options &opts);
     virtual ~CanonicalPDBsHeuristic() = default;
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 
 void add_canonical_pdbs_options_to_feature(plugins::Feature &feature);
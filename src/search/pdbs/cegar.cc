@@ -24,11 +24,13 @@ namespace pdbs {
   the PDB (and with that, the pattern) and an optimal plan (in the wildcard
   format) for that PDB if it exists or unsolvable is true otherwise. It can
   be marked as "solved" to ignore it in further iterations of the CEGAR
-  algorithm.
+  algorithm. The abstract operators of the projection are kept to speed up
+  computing the PDBs of refined patterns.
 */
 class PatternInfo {
     shared_ptr<PatternDatabase> pdb;
     vector<vector<OperatorID>> plan;
+    unique_ptr<ProjectionOperators> projection_operators;
     bool unsolvable;
     bool solved;
 
@@ -36,9 +38,11 @@ public:
     PatternInfo(
         const shared_ptr<PatternDatabase> &&pdb,
         const vector<vector<OperatorID>> &&plan,
+        unique_ptr<ProjectionOperators> &&projection_operators,
         bool unsolvable)
         : pdb(move(pdb)),
           plan(move(plan)),
+          projection_operators(move(projection_operators)),
           unsolvable(unsolvable),
           solved(false) {}
 
@@ -54,6 +58,10 @@ public:
         return plan;
     }
 
+    const ProjectionOperators &get_projection_operators() const {
+        return *projection_operators;
+    }
+
     bool is_unsolvable() const {
         return unsolvable;
     }
@@ -90,6 +98,7 @@ class CEGAR {
     const TaskProxy task_proxy;
     const vector<FactPair> &goals;
     unordered_set<int> blacklisted_variables;
+    IncrementalPDBFactory pdb_factory;
 
     vector<unique_ptr<PatternInfo>> pattern_collection;
     /*
@@ -102,7 +111,13 @@ class CEGAR {
     void print_collection() const;
     bool time_limit_reached(const utils::CountdownTimer &timer) const;
 
-    unique_ptr<PatternInfo> compute_pattern_info(Pattern &&pattern) const;
+    /*
+      Compute the PDB and plan for the given pattern. The patterns of the
+      given collection entries must be disjoint subsets of the pattern.
+    */
+    unique_ptr<PatternInfo> compute_pattern_info(
+        Pattern &&pattern,
+        const vector<const PatternInfo *> &base_pattern_infos = {}) const;
     void compute_initial_collection();
 
     /*
@@ -179,6 +194,7 @@ CEGAR::CEGAR(
       task_proxy(*task),
       goals(goals),
       blacklisted_variables(move(blacklisted_variables)),
+      pdb_factory(task_proxy),
       collection_size(0) {
 #ifndef NDEBUG
     for (const FactPair &goal : goals) {
@@ -224,10 +240,16 @@ bool CEGAR::time_limit_reached(
     return false;
 }
 
-unique_ptr<PatternInfo> CEGAR::compute_pattern_info(Pattern &&pattern) const {
-    vector<int> op_cost;
-    auto [pdb, plan] = compute_pdb_and_plan(
-        task_proxy, pattern, op_cost, rng, use_wildcard_plans);
+unique_ptr<PatternInfo> CEGAR::compute_pattern_info(
+    Pattern &&pattern,
+    const vector<const PatternInfo *> &base_pattern_infos) const {
+    vector<const ProjectionOperators *> base_projections;
+    base_projections.reserve(base_pattern_infos.size());
+    for (const PatternInfo *base_pattern_info : base_pattern_infos) {
+        base_projections.push_back(&base_pattern_info->get_projection_operators());
+    }
+    auto [pdb, plan, projection_operators] = pdb_factory.compute_pdb_and_plan(
+        pattern, base_projections, rng, use_wildcard_plans);
 
     bool unsolvable = false;
     State initial_state = task_proxy.get_initial_state();
@@ -253,7 +275,8 @@ unique_ptr<PatternInfo> CEGAR::compute_pattern_info(Pattern &&pattern) const {
             log << "##### End of plan #####" << endl;
         }
     }
-    return utils::make_unique_ptr<PatternInfo>(move(pdb), move(plan), unsolvable);
+    return utils::make_unique_ptr<PatternInfo>(
+        move(pdb), move(plan), move(projection_operators), unsolvable);
 }
 
 void CEGAR::compute_initial_collection() {
@@ -464,7 +487,8 @@ void CEGAR::merge_patterns(int index1, int index2) {
     int pdb_size2 = pattern_collection[index2]->get_pdb()->get_size();
 
     // Compute merged_pattern_info pattern.
-    unique_ptr<PatternInfo> merged_pattern_info = compute_pattern_info(move(new_pattern));
+    unique_ptr<PatternInfo> merged_pattern_info = compute_pattern_info(
+        move(new_pattern), {&pattern_info1, &pattern_info2});
 
     // Update collection size.
     collection_size -= pdb_size1;
@@ -493,7 +517,8 @@ void CEGAR::add_variable_to_pattern(int collection_index, int var) {
     new_pattern.push_back(var);
     sort(new_pattern.begin(), new_pattern.end());
 
-    unique_ptr<PatternInfo> new_pattern_info = compute_pattern_info(move(new_pattern));
+    unique_ptr<PatternInfo> new_pattern_info = compute_pattern_info(
+        move(new_pattern), {&pattern_info});
 
     collection_size -= pattern_info.get_pdb()->get_size();
     collection_size += new_pattern_info->get_pdb()->get_size();
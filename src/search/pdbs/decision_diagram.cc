@@ -0,0 +1,303 @@
+#include "decision_diagram.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+
+using namespace std;
+
+namespace pdbs {
+static const int INF = numeric_limits<int>::max();
+
+static bool is_commutative(DecisionDiagramManager::Operation op) {
+    return op == DecisionDiagramManager::Operation::AND ||
+           op == DecisionDiagramManager::Operation::OR ||
+           op == DecisionDiagramManager::Operation::MIN;
+}
+
+DecisionDiagramManager::DecisionDiagramManager(const vector<int> &domain_sizes)
+    : domain_sizes(domain_sizes) {
+}
+
+int DecisionDiagramManager::get_terminal(int value) {
+    auto it = terminal_table.find(value);
+    if (it != terminal_table.end()) {
+        return it->second;
+    }
+    int node = nodes.size();
+    nodes.push_back({get_num_levels(), value});
+    terminal_table[value] = node;
+    return node;
+}
+
+int DecisionDiagramManager::get_child_on_level(
+    int node, int level, int value) const {
+    if (nodes[node].level == level) {
+        return get_child(node, value);
+    }
+    // The node does not test the variable of this level.
+    assert(nodes[node].level > level);
+    return node;
+}
+
+int DecisionDiagramManager::make_node(int level, const vector<int> &node_children) {
+    assert(static_cast<int>(node_children.size()) == domain_sizes[level]);
+    if (all_of(node_children.begin(), node_children.end(),
+               [&](int child) {return child == node_children[0];})) {
+        return node_children[0];
+    }
+    vector<int> key;
+    key.reserve(node_children.size() + 1);
+    key.push_back(level);
+    key.insert(key.end(), node_children.begin(), node_children.end());
+    auto it = unique_table.find(key);
+    if (it != unique_table.end()) {
+        return it->second;
+    }
+    int node = nodes.size();
+    nodes.push_back({level, static_cast<int>(children.size())});
+    children.insert(children.end(), node_children.begin(), node_children.end());
+    unique_table.emplace(move(key), node);
+    return node;
+}
+
+int DecisionDiagramManager::make_cube(vector<pair<int, int>> facts) {
+    sort(facts.begin(), facts.end(), greater<pair<int, int>>());
+    int false_node = get_terminal(0);
+    int node = get_terminal(1);
+    for (const pair<int, int> &fact : facts) {
+        vector<int> node_children(domain_sizes[fact.first], false_node);
+        node_children[fact.second] = node;
+        node = make_node(fact.first, node_children);
+    }
+    return node;
+}
+
+int DecisionDiagramManager::apply_to_values(
+    Operation op, int value1, int value2) {
+    switch (op) {
+    case Operation::AND:
+        return value1 && value2;
+    case Operation::OR:
+        return value1 || value2;
+    case Operation::AND_NOT:
+        return value1 && !value2;
+    case Operation::MIN:
+        return min(value1, value2);
+    case Operation::MASK:
+        return value1 ? value2 : INF;
+    }
+    assert(false);
+    return 0;
+}
+
+int DecisionDiagramManager::apply(Operation op, int node1, int node2) {
+    if (is_terminal(node1) && is_terminal(node2)) {
+        return get_terminal(apply_to_values(
+                                op, get_terminal_value(node1), get_terminal_value(node2)));
+    }
+
+    // Shortcuts for operations where one operand determines the result.
+    int false_node = get_terminal(0);
+    int true_node = get_terminal(1);
+    switch (op) {
+    case Operation::AND:
+        if (node1 == false_node || node2 == false_node)
+            return false_node;
+        if (node1 == true_node || node1 == node2)
+            return node2;
+        if (node2 == true_node)
+            return node1;
+        break;
+    case Operation::OR:
+        if (node1 == true_node || node2 == true_node)
+            return true_node;
+        if (node1 == false_node || node1 == node2)
+            return node2;
+        if (node2 == false_node)
+            return node1;
+        break;
+    case Operation::AND_NOT:
+        if (node1 == false_node || node2 == true_node || node1 == node2)
+            return false_node;
+        if (node2 == false_node)
+            return node1;
+        break;
+    case Operation::MIN:
+        if (node1 == node2 || node2 == get_terminal(INF))
+            return node1;
+        if (node1 == get_terminal(INF))
+            return node2;
+        break;
+    case Operation::MASK:
+        if (node1 == false_node)
+            return get_terminal(INF);
+        if (node1 == true_node)
+            return node2;
+        break;
+    }
+
+    if (is_commutative(op) && node1 > node2) {
+        swap(node1, node2);
+    }
+    pair<int, pair<int, int>> key(static_cast<int>(op), make_pair(node1, node2));
+    auto it = computed_table.find(key);
+    if (it != computed_table.end()) {
+        return it->second;
+    }
+
+    int level = min(get_level(node1), get_level(node2));
+    vector<int> result_children(domain_sizes[level]);
+    for (int value = 0; value < domain_sizes[level]; ++value) {
+        result_children[value] = apply(
+            op,
+            get_child_on_level(node1, level, value),
+            get_child_on_level(node2, level, value));
+    }
+    int result = make_node(level, result_children);
+    computed_table[key] = result;
+    return result;
+}
+
+int DecisionDiagramManager::restrict_recursive(
+    int node, int level, int value, utils::HashMap<int, int> &cache) {
+    int node_level = get_level(node);
+    if (node_level > level) {
+        return node;
+    } else if (node_level == level) {
+        return get_child(node, value);
+    }
+    auto it = cache.find(node);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    vector<int> result_children(domain_sizes[node_level]);
+    for (int child_value = 0; child_value < domain_sizes[node_level]; ++child_value) {
+        result_children[child_value] = restrict_recursive(
+            get_child(node, child_value), level, value, cache);
+    }
+    int result = make_node(node_level, result_children);
+    cache[node] = result;
+    return result;
+}
+
+int DecisionDiagramManager::restrict(int node, int level, int value) {
+    utils::HashMap<int, int> cache;
+    return restrict_recursive(node, level, value, cache);
+}
+
+
+DistanceDiagram::DistanceDiagram(
+    const DecisionDiagramManager &manager, int manager_root,
+    const Pattern &pattern)
+    : pattern(pattern),
+      num_inner_nodes(0) {
+    assert(static_cast<int>(pattern.size()) == manager.get_num_levels());
+    for (int level = 0; level < manager.get_num_levels(); ++level) {
+        domain_sizes.push_back(manager.get_domain_size(level));
+    }
+
+    /*
+      Encode the nodes reachable from the root in post-order, so children
+      are stored before their parents.
+    */
+    utils::HashMap<int, int> encoded_nodes;
+    utils::HashMap<int, int> terminal_indices;
+    function<int(int)> encode = [&](int node) {
+        if (manager.is_terminal(node)) {
+            int value = manager.get_terminal_value(node);
+            auto it = terminal_indices.find(value);
+            if (it == terminal_indices.end()) {
+                it = terminal_indices.emplace(value, terminal_values.size()).first;
+                terminal_values.push_back(value);
+            }
+            return -(it->second + 1);
+        }
+        auto it = encoded_nodes.find(node);
+        if (it != encoded_nodes.end()) {
+            return it->second;
+        }
+        int level = manager.get_level(node);
+        vector<int> encoded_children;
+        encoded_children.reserve(domain_sizes[level]);
+        for (int value = 0; value < domain_sizes[level]; ++value) {
+            encoded_children.push_back(encode(manager.get_child(node, value)));
+        }
+        int offset = code.size();
+        code.push_back(pattern[level]);
+        code.insert(code.end(), encoded_children.begin(), encoded_children.end());
+        encoded_nodes[node] = offset;
+        ++num_inner_nodes;
+        return offset;
+    };
+    root = encode(manager_root);
+    code.shrink_to_fit();
+}
+
+int DistanceDiagram::get_level(int node) const {
+    if (node < 0) {
+        return pattern.size();
+    }
+    return lower_bound(pattern.begin(), pattern.end(), code[node]) - pattern.begin();
+}
+
+double DistanceDiagram::compute_mean_finite_h() const {
+    /*
+      For every inner node, count the finite distances and sum them up
+      over all assignments to the variables of its level and the levels
+      below it. Children are stored before their parents.
+    */
+    vector<double> num_finite(code.size(), 0);
+    vector<double> sum_finite(code.size(), 0);
+    auto add_child = [&](int child, int from_level, double &count, double &sum) {
+        double child_count;
+        double child_sum;
+        if (child < 0) {
+            int h = terminal_values[-child - 1];
+            child_count = (h == INF) ? 0 : 1;
+            child_sum = (h == INF) ? 0 : h;
+        } else {
+            child_count = num_finite[child];
+            child_sum = sum_finite[child];
+        }
+        double num_skipped_states = 1;
+        for (int level = from_level; level < get_level(child); ++level) {
+            num_skipped_states *= domain_sizes[level];
+        }
+        count += num_skipped_states * child_count;
+        sum += num_skipped_states * child_sum;
+    };
+    int node = 0;
+    while (node < static_cast<int>(code.size())) {
+        int level = get_level(node);
+        for (int value = 0; value < domain_sizes[level]; ++value) {
+            add_child(code[node + 1 + value], level + 1,
+                      num_finite[node], sum_finite[node]);
+        }
+        node += 1 + domain_sizes[level];
+    }
+    double count = 0;
+    double sum = 0;
+    add_child(root, 0, count, sum);
+    if (count == 0) { // All states are dead ends.
+        return numeric_limits<double>::infinity();
+    }
+    return sum / count;
+}
+
+int DistanceDiagram::compute_max_finite_h() const {
+    int max_h = 0;
+    for (int h : terminal_values) {
+        if (h != INF) {
+            max_h = max(max_h, h);
+        }
+    }
+    return max_h;
+}
+
+bool DistanceDiagram::has_dead_ends() const {
+    return find(terminal_values.begin(), terminal_values.end(), INF) !=
+           terminal_values.end();
+}
+}
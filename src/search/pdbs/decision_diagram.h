@@ -0,0 +1,159 @@
+#ifndef PDBS_DECISION_DIAGRAM_H
+#define PDBS_DECISION_DIAGRAM_H
+
+#include "types.h"
+
+#include "../utils/hash.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pdbs {
+/*
+  Reduced ordered multi-valued decision diagrams with integer terminals
+  (multi-terminal MDDs, i.e., ADDs over finite-domain variables).
+
+  Levels correspond to the variables of a pattern in increasing order.
+  Every inner node tests the variable of its level and has one child per
+  value of the variable. Children are on higher levels than their
+  parents, and levels that are skipped on a path do not influence the
+  value of the function. Terminals are on level num_levels. Sets of
+  abstract states are represented by diagrams with terminals 0 and 1.
+
+  The manager guarantees that equal functions are represented by the same
+  node, so comparing functions means comparing node IDs. Results of
+  apply() are memoized. Nodes are never deleted: a manager is meant to be
+  used for building a single diagram and discarded afterwards (see
+  DistanceDiagram for the compact representation used for lookups).
+*/
+class DecisionDiagramManager {
+public:
+    enum class Operation {
+        AND,
+        OR,
+        AND_NOT,
+        MIN,
+        // MASK(a, b) = b if a != 0 and infinity otherwise.
+        MASK
+    };
+
+private:
+    struct Node {
+        int level;
+        // Position of the children in the children vector or terminal value.
+        int first_child;
+    };
+
+    std::vector<int> domain_sizes;
+    std::vector<Node> nodes;
+    std::vector<int> children;
+    // Maps [level, child_0, ..., child_k] to the node with these children.
+    utils::HashMap<std::vector<int>, int> unique_table;
+    utils::HashMap<int, int> terminal_table;
+    utils::HashMap<std::pair<int, std::pair<int, int>>, int> computed_table;
+
+    int get_child_on_level(int node, int level, int value) const;
+    static int apply_to_values(Operation op, int value1, int value2);
+    int restrict_recursive(
+        int node, int level, int value, utils::HashMap<int, int> &cache);
+public:
+    explicit DecisionDiagramManager(const std::vector<int> &domain_sizes);
+
+    int get_num_levels() const {
+        return domain_sizes.size();
+    }
+
+    int get_domain_size(int level) const {
+        return domain_sizes[level];
+    }
+
+    int get_num_nodes() const {
+        return nodes.size();
+    }
+
+    int get_terminal(int value);
+
+    bool is_terminal(int node) const {
+        return nodes[node].level == get_num_levels();
+    }
+
+    int get_terminal_value(int node) const {
+        return nodes[node].first_child;
+    }
+
+    int get_level(int node) const {
+        return nodes[node].level;
+    }
+
+    int get_child(int node, int value) const {
+        return children[nodes[node].first_child + value];
+    }
+
+    /*
+      Return the node with the given children on the given level (or the
+      child if all children are equal).
+    */
+    int make_node(int level, const std::vector<int> &node_children);
+
+    /*
+      Return the set of states that satisfy all given facts, which are
+      given as pairs of levels and values.
+    */
+    int make_cube(std::vector<std::pair<int, int>> facts);
+
+    int apply(Operation op, int node1, int node2);
+
+    // Return the function with the variable of the given level fixed to value.
+    int restrict(int node, int level, int value);
+};
+
+/*
+  Compact read-only representation of a decision diagram whose terminals
+  are goal distances (with numeric_limits<int>::max() for dead-ends).
+
+  All inner nodes are stored in a single vector<int> as
+  [var_id, child_0, ..., child_{domain_size - 1}]. Children that are inner
+  nodes are given by their offset, terminals by -(index + 1), where index
+  refers to terminal_values. Looking up a state walks from the root to a
+  terminal, which reads at most one entry per pattern variable.
+*/
+class DistanceDiagram {
+    Pattern pattern;
+    std::vector<int> domain_sizes;
+    std::vector<int> code;
+    std::vector<int> terminal_values;
+    int root;
+    int num_inner_nodes;
+
+    int get_level(int node) const;
+public:
+    DistanceDiagram(
+        const DecisionDiagramManager &manager, int root, const Pattern &pattern);
+
+    // get_value(var_id) must return the value of the given task variable.
+    template<typename ValueReader>
+    int evaluate(const ValueReader &get_value) const {
+        int node = root;
+        while (node >= 0) {
+            node = code[node + 1 + get_value(code[node])];
+        }
+        return terminal_values[-node - 1];
+    }
+
+    int get_num_inner_nodes() const {
+        return num_inner_nodes;
+    }
+
+    int64_t get_size_in_bytes() const {
+        return (code.size() + terminal_values.size()) * sizeof(int);
+    }
+
+    // See PatternDatabase for the semantics of these methods.
+    double compute_mean_finite_h() const;
+    int compute_max_finite_h() const;
+    bool has_dead_ends() const;
+};
+}
+
+#endif
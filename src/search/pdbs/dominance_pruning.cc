@@ -37,10 +37,18 @@ class Pruner {
       current clique, we check that all entries variable_to_pattern_id[v_i]
       are equal and different from -1.
 
-      "dominated_patterns" is a vector<bool> that can be used to
-      quickly test whether a given pattern is dominated by the current
-      clique. This is precomputed for every pattern whenever the
-      current clique is set.
+      "dominated_patterns" caches whether a given pattern is dominated
+      by the current clique. Entries are computed lazily when a clique
+      containing the pattern is tested and are only valid if
+      "dominance_stamps" for the pattern equals the ID of the current
+      clique. This avoids testing all patterns whenever the current clique
+      is set: since pattern cliques are usually maximal and hence rarely
+      dominated, testing a clique typically stops at its first pattern.
+
+      If the pattern cliques are maximal and distinct (as computed by
+      compute_pattern_cliques() or maintained by
+      add_pattern_to_pattern_cliques()), no two cliques dominate each
+      other, so the result does not depend on the order of the cliques.
     */
 
     const PatternCollection &patterns;
@@ -49,13 +57,16 @@ class Pruner {
 
     vector<int> variable_to_pattern_id;
     vector<bool> dominated_patterns;
+    vector<int> dominance_stamps;
+    int current_clique_id;
 
     void set_current_clique(int clique_id) {
         /*
           Set the current pattern collection to be used for
-          is_pattern_dominated() or is_collection_dominated(). Compute
-          dominated_patterns based on the current pattern collection.
+          is_pattern_dominated() or is_collection_dominated(). This
+          invalidates all cached entries of dominated_patterns.
         */
+        current_clique_id = clique_id;
         variable_to_pattern_id.assign(num_variables, -1);
         assert(variable_to_pattern_id == vector<int>(num_variables, -1));
         for (PatternID pattern_id : pattern_cliques[clique_id]) {
@@ -64,12 +75,6 @@ class Pruner {
                 variable_to_pattern_id[variable] = pattern_id;
             }
         }
-
-        dominated_patterns.clear();
-        dominated_patterns.reserve(patterns.size());
-        for (size_t i = 0; i < patterns.size(); ++i) {
-            dominated_patterns.push_back(is_pattern_dominated(i));
-        }
     }
 
     bool is_pattern_dominated(int pattern_id) const {
@@ -92,13 +97,21 @@ class Pruner {
         return true;
     }
 
-    bool is_clique_dominated(int clique_id) const {
+    bool is_pattern_dominated_cached(int pattern_id) {
+        if (dominance_stamps[pattern_id] != current_clique_id) {
+            dominance_stamps[pattern_id] = current_clique_id;
+            dominated_patterns[pattern_id] = is_pattern_dominated(pattern_id);
+        }
+        return dominated_patterns[pattern_id];
+    }
+
+    bool is_clique_dominated(int clique_id) {
         /*
           Check if the collection with the given collection_id is
           dominated by the current pattern collection.
         */
         for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            if (!dominated_patterns[pattern_id]) {
+            if (!is_pattern_dominated_cached(pattern_id)) {
                 return false;
             }
         }
@@ -112,7 +125,10 @@ public:
         int num_variables)
         : patterns(patterns),
           pattern_cliques(pattern_cliques),
-          num_variables(num_variables) {
+          num_variables(num_variables),
+          dominated_patterns(patterns.size(), false),
+          dominance_stamps(patterns.size(), -1),
+          current_clique_id(-1) {
     }
 
     vector<bool> get_pruned_cliques(
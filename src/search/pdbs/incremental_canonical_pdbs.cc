@@ -1,9 +1,11 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
 #include "pattern_database_factory.h"
 
+#include "../algorithms/max_cliques.h"
+#include "../utils/memory.h"
+
 #include <limits>
 
 using namespace std;
@@ -21,7 +23,11 @@ IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
     for (const Pattern &pattern : *patterns)
         add_pdb_for_pattern(pattern);
     are_additive = compute_additive_vars(task_proxy);
-    recompute_pattern_cliques();
+    compatibility_graph = compute_compatibility_graph(*patterns, are_additive);
+    pattern_cliques = make_shared<vector<PatternClique>>();
+    max_cliques::compute_max_cliques(compatibility_graph, *pattern_cliques);
+    canonical_pdbs = utils::make_unique_ptr<CanonicalPDBs>(
+        pattern_databases, pattern_cliques);
 }
 
 void IncrementalCanonicalPDBs::add_pdb_for_pattern(const Pattern &pattern) {
@@ -33,23 +39,23 @@ void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
     patterns->push_back(pdb->get_pattern());
     pattern_databases->push_back(pdb);
     size += pattern_databases->back()->get_size();
-    recompute_pattern_cliques();
-}
-
-void IncrementalCanonicalPDBs::recompute_pattern_cliques() {
-    pattern_cliques = compute_pattern_cliques(*patterns,
-                                              are_additive);
+    /* The old cliques may be shared with users of the collection, so we
+       update a copy. */
+    pattern_cliques = make_shared<vector<PatternClique>>(*pattern_cliques);
+    add_pattern_to_pattern_cliques(
+        *patterns, are_additive, compatibility_graph, *pattern_cliques);
+    canonical_pdbs = utils::make_unique_ptr<CanonicalPDBs>(
+        pattern_databases, pattern_cliques);
 }
 
 vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
-    const Pattern &new_pattern) {
+    const Pattern &new_pattern) const {
     return pdbs::compute_pattern_cliques_with_pattern(
-        *patterns, *pattern_cliques, new_pattern, are_additive);
+        *patterns, compatibility_graph, new_pattern, are_additive);
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
-    return canonical_pdbs.get_value(state);
+    return canonical_pdbs->get_value(state);
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
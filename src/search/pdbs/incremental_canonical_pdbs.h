@@ -1,6 +1,7 @@
 #ifndef PDBS_INCREMENTAL_CANONICAL_PDBS_H
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
+#include "canonical_pdbs.h"
 #include "pattern_cliques.h"
 #include "pattern_collection_information.h"
 #include "types.h"
@@ -16,6 +17,10 @@ class IncrementalCanonicalPDBs {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Maintained together with the pattern cliques.
+    CompatibilityGraph compatibility_graph;
+    // Recompiled whenever the pattern cliques change.
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
@@ -23,21 +28,23 @@ class IncrementalCanonicalPDBs {
     // The sum of all abstract state sizes of all pdbs in the collection.
     int size;
 
-    // Adds a PDB for pattern but does not recompute pattern_cliques.
+    // Adds a PDB for pattern but does not update pattern_cliques.
     void add_pdb_for_pattern(const Pattern &pattern);
-
-    void recompute_pattern_cliques();
 public:
     IncrementalCanonicalPDBs(const TaskProxy &task_proxy,
                              const PatternCollection &intitial_patterns);
     virtual ~IncrementalCanonicalPDBs() = default;
 
-    // Adds a new PDB to the collection and recomputes pattern_cliques.
+    /*
+      Adds a new PDB to the collection and updates pattern_cliques
+      incrementally (see add_pattern_to_pattern_cliques in
+      pattern_cliques.h).
+    */
     void add_pdb(const std::shared_ptr<PatternDatabase> &pdb);
 
     /* Returns a list of pattern cliques that would be additive to the new
-       pattern. Detailed documentation in max_additive_pdb_sets.h */
-    std::vector<PatternClique> get_pattern_cliques(const Pattern &new_pattern);
+       pattern. Detailed documentation in pattern_cliques.h */
+    std::vector<PatternClique> get_pattern_cliques(const Pattern &new_pattern) const;
 
     int get_value(const State &state) const;
 
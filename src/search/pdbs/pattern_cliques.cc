@@ -6,6 +6,9 @@
 
 #include "../algorithms/max_cliques.h"
 
+#include <algorithm>
+#include <cassert>
+
 using namespace std;
 
 namespace pdbs {
@@ -38,12 +41,9 @@ VariableAdditivity compute_additive_vars(const TaskProxy &task_proxy) {
     return are_additive;
 }
 
-shared_ptr<vector<PatternClique>> compute_pattern_cliques(
+CompatibilityGraph compute_compatibility_graph(
     const PatternCollection &patterns, const VariableAdditivity &are_additive) {
-    // Initialize compatibility graph.
-    vector<vector<int>> cgraph;
-    cgraph.resize(patterns.size());
-
+    CompatibilityGraph cgraph(patterns.size());
     for (size_t i = 0; i < patterns.size(); ++i) {
         for (size_t j = i + 1; j < patterns.size(); ++j) {
             if (are_patterns_additive(patterns[i], patterns[j], are_additive)) {
@@ -54,37 +54,106 @@ shared_ptr<vector<PatternClique>> compute_pattern_cliques(
             }
         }
     }
+    return cgraph;
+}
 
+shared_ptr<vector<PatternClique>> compute_pattern_cliques(
+    const PatternCollection &patterns, const VariableAdditivity &are_additive) {
+    CompatibilityGraph cgraph = compute_compatibility_graph(patterns, are_additive);
     shared_ptr<vector<PatternClique>> max_cliques = make_shared<vector<PatternClique>>();
     max_cliques::compute_max_cliques(cgraph, *max_cliques);
     return max_cliques;
 }
 
+/*
+  Return the IDs (in increasing order) of the first num_patterns patterns
+  that are additive with the given pattern.
+*/
+static vector<PatternID> compute_additive_patterns(
+    const PatternCollection &patterns, int num_patterns,
+    const Pattern &new_pattern, const VariableAdditivity &are_additive) {
+    vector<PatternID> additive_patterns;
+    for (PatternID pattern_id = 0; pattern_id < num_patterns; ++pattern_id) {
+        if (are_patterns_additive(new_pattern, patterns[pattern_id], are_additive)) {
+            additive_patterns.push_back(pattern_id);
+        }
+    }
+    return additive_patterns;
+}
+
+// Compute the maximal cliques of the subgraph induced by the given vertices.
+static vector<PatternClique> compute_max_cliques_of_subgraph(
+    const CompatibilityGraph &cgraph, const vector<PatternID> &vertices) {
+    vector<int> vertex_to_subgraph_vertex(cgraph.size(), -1);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertex_to_subgraph_vertex[vertices[i]] = i;
+    }
+    /* Since the vertices are sorted, renumbering them preserves the order
+       of the adjacency lists. */
+    CompatibilityGraph subgraph(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        for (int neighbor : cgraph[vertices[i]]) {
+            int subgraph_neighbor = vertex_to_subgraph_vertex[neighbor];
+            if (subgraph_neighbor != -1) {
+                subgraph[i].push_back(subgraph_neighbor);
+            }
+        }
+    }
+    vector<PatternClique> max_cliques;
+    max_cliques::compute_max_cliques(subgraph, max_cliques);
+    for (PatternClique &clique : max_cliques) {
+        for (PatternID &pattern_id : clique) {
+            pattern_id = vertices[pattern_id];
+        }
+    }
+    return max_cliques;
+}
+
 vector<PatternClique> compute_pattern_cliques_with_pattern(
     const PatternCollection &patterns,
-    const vector<PatternClique> &known_pattern_cliques,
+    const CompatibilityGraph &compatibility_graph,
     const Pattern &new_pattern,
     const VariableAdditivity &are_additive) {
-    vector<PatternClique> cliques_additive_with_pattern;
-    for (const PatternClique &known_clique : known_pattern_cliques) {
-        // Take all patterns which are additive to new_pattern.
-        PatternClique new_clique;
-        new_clique.reserve(known_clique.size());
-        for (PatternID pattern_id : known_clique) {
-            if (are_patterns_additive(
-                    new_pattern, patterns[pattern_id], are_additive)) {
-                new_clique.push_back(pattern_id);
-            }
-        }
-        if (!new_clique.empty()) {
-            cliques_additive_with_pattern.push_back(new_clique);
+    vector<PatternID> additive_patterns = compute_additive_patterns(
+        patterns, patterns.size(), new_pattern, are_additive);
+    return compute_max_cliques_of_subgraph(compatibility_graph, additive_patterns);
+}
+
+void add_pattern_to_pattern_cliques(
+    const PatternCollection &patterns,
+    const VariableAdditivity &are_additive,
+    CompatibilityGraph &compatibility_graph,
+    vector<PatternClique> &pattern_cliques) {
+    assert(!patterns.empty());
+    PatternID new_pattern_id = patterns.size() - 1;
+    assert(static_cast<int>(compatibility_graph.size()) == new_pattern_id);
+    vector<PatternID> additive_patterns = compute_additive_patterns(
+        patterns, new_pattern_id, patterns.back(), are_additive);
+    vector<PatternClique> additive_cliques =
+        compute_max_cliques_of_subgraph(compatibility_graph, additive_patterns);
+
+    vector<bool> is_additive(new_pattern_id, false);
+    for (PatternID pattern_id : additive_patterns) {
+        is_additive[pattern_id] = true;
+    }
+    vector<PatternClique> new_pattern_cliques;
+    new_pattern_cliques.reserve(pattern_cliques.size() + additive_cliques.size());
+    for (PatternClique &clique : pattern_cliques) {
+        if (!all_of(clique.begin(), clique.end(),
+                    [&](PatternID pattern_id) {return is_additive[pattern_id];})) {
+            new_pattern_cliques.push_back(move(clique));
         }
     }
-    if (cliques_additive_with_pattern.empty()) {
-        // If nothing was additive with the new variable, then
-        // the only clique is the empty set.
-        cliques_additive_with_pattern.emplace_back();
+    for (PatternClique &clique : additive_cliques) {
+        clique.push_back(new_pattern_id);
+        new_pattern_cliques.push_back(move(clique));
+    }
+    pattern_cliques.swap(new_pattern_cliques);
+
+    // The new pattern has the largest ID, so the adjacency lists stay sorted.
+    for (PatternID pattern_id : additive_patterns) {
+        compatibility_graph[pattern_id].push_back(new_pattern_id);
     }
-    return cliques_additive_with_pattern;
+    compatibility_graph.push_back(move(additive_patterns));
 }
 }
@@ -11,8 +11,10 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
+#include "../utils/thread_pool.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
@@ -32,9 +34,13 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
+      num_threads(opts.get<int>("num_threads")),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
+PatternCollectionGeneratorGenetic::~PatternCollectionGeneratorGenetic() {
+}
+
 void PatternCollectionGeneratorGenetic::select(
     const vector<double> &fitness_values) {
     vector<double> cumulative_fitness;
@@ -161,13 +167,16 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
 
 void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
-    for (size_t i = 0; i < pattern_collections.size(); ++i) {
+    int num_pattern_collections = pattern_collections.size();
+    // Valid pattern collections in normal form, nullptr for invalid ones.
+    vector<shared_ptr<PatternCollection>> normal_form_collections(
+        num_pattern_collections);
+    for (int i = 0; i < num_pattern_collections; ++i) {
         const auto &collection = pattern_collections[i];
         if (log.is_at_least_debug()) {
             log << "evaluate pattern collection " << (i + 1) << " of "
                 << pattern_collections.size() << endl;
         }
-        double fitness = 0;
         bool pattern_valid = true;
         vector<bool> variables_used(task_proxy.get_variables().size(), false);
         shared_ptr<PatternCollection> pattern_collection = make_shared<PatternCollection>();
@@ -196,23 +205,34 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
             remove_irrelevant_variables(pattern);
             pattern_collection->push_back(pattern);
         }
-        if (!pattern_valid) {
-            /* Set fitness to a very small value to cover cases in which all
-               patterns are invalid. */
-            fitness = 0.001;
-        } else {
-            /* Generate the pattern collection heuristic and get its fitness
-               value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
-            // Update the best heuristic found so far.
-            if (fitness > best_fitness) {
-                best_fitness = fitness;
-                if (log.is_at_least_normal()) {
-                    log << "best_fitness = " << best_fitness << endl;
-                }
-                best_patterns = pattern_collection;
+        if (pattern_valid) {
+            normal_form_collections[i] = pattern_collection;
+        }
+    }
+
+    /* Set the fitness of invalid pattern collections to a very small value
+       to cover cases in which all patterns are invalid. */
+    vector<double> new_fitness_values(num_pattern_collections, 0.001);
+    thread_pool->parallel_for(
+        num_pattern_collections,
+        [&](int i) {
+            if (normal_form_collections[i]) {
+                /* Generate the pattern collection heuristic and get its
+                   fitness value. */
+                ZeroOnePDBs zero_one_pdbs(task_proxy, *normal_form_collections[i]);
+                new_fitness_values[i] = zero_one_pdbs.compute_approx_mean_finite_h();
+            }
+        });
+
+    for (int i = 0; i < num_pattern_collections; ++i) {
+        double fitness = new_fitness_values[i];
+        // Update the best heuristic found so far.
+        if (normal_form_collections[i] && fitness > best_fitness) {
+            best_fitness = fitness;
+            if (log.is_at_least_normal()) {
+                log << "best_fitness = " << best_fitness << endl;
             }
+            best_patterns = normal_form_collections[i];
         }
         fitness_values.push_back(fitness);
     }
@@ -268,6 +288,7 @@ void PatternCollectionGeneratorGenetic::bin_packing() {
 void PatternCollectionGeneratorGenetic::genetic_algorithm() {
     best_fitness = -1;
     best_patterns = nullptr;
+    thread_pool = utils::make_unique_ptr<utils::ThreadPool>(num_threads);
     bin_packing();
     vector<double> initial_fitness_values;
     evaluate(initial_fitness_values);
@@ -281,6 +302,7 @@ void PatternCollectionGeneratorGenetic::genetic_algorithm() {
         // We allow to select invalid pattern collections.
         select(fitness_values);
     }
+    thread_pool = nullptr;
 }
 
 string PatternCollectionGeneratorGenetic::name() const {
@@ -344,6 +366,13 @@ public:
             "consider a pattern collection invalid (giving it very low "
             "fitness) if its patterns are not disjoint",
             "false");
+        add_option<int>(
+            "num_threads",
+            "number of threads used to evaluate the pattern collections. The "
+            "resulting pattern collection does not depend on the number of "
+            "threads.",
+            "1",
+            plugins::Bounds("1", "infinity"));
         utils::add_rng_options(*this);
         add_generator_options_to_feature(*this);
 
@@ -11,6 +11,7 @@ class AbstractTask;
 
 namespace utils {
 class RandomNumberGenerator;
+class ThreadPool;
 }
 
 namespace pdbs {
@@ -29,8 +30,12 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     /* Specifies whether patterns in each pattern collection need to be disjoint
        or not. */
     const bool disjoint_patterns;
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
+    // Used to compute the fitness values in parallel.
+    std::unique_ptr<utils::ThreadPool> thread_pool;
+
     std::shared_ptr<AbstractTask> task;
 
     // All current pattern collections.
@@ -75,6 +80,11 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
       ( = summed up mean h-values (dead ends are ignored) of all PDBs in the
       collection) computed. The overall best heuristic is eventually updated and
       saved for further episodes.
+
+      The heuristics of the pattern collections are computed in parallel.
+      Since this does not use the random number generator and the best
+      pattern collection is updated in the order of the collections
+      afterwards, the result does not depend on the number of threads.
     */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const Pattern &pattern) const;
@@ -114,6 +124,7 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
         const std::shared_ptr<AbstractTask> &task) override;
 public:
     explicit PatternCollectionGeneratorGenetic(const plugins::Options &opts);
+    virtual ~PatternCollectionGeneratorGenetic() override;
 };
 }
 
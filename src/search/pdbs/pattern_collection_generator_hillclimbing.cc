@@ -4,6 +4,7 @@
 #include "incremental_canonical_pdbs.h"
 #include "pattern_database.h"
 #include "pattern_database_factory.h"
+#include "symbolic_pdb_factory.h"
 #include "utils.h"
 #include "validation.h"
 
@@ -19,9 +20,11 @@
 #include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
+#include "../utils/thread_pool.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -119,11 +122,15 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      num_threads(opts.get<int>("num_threads")),
       rng(utils::parse_rng_from_options(opts)),
       num_rejected(0),
       hill_climbing_timer(0) {
 }
 
+PatternCollectionGeneratorHillclimbing::~PatternCollectionGeneratorHillclimbing() {
+}
+
 int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     const TaskProxy &task_proxy,
     const vector<vector<int>> &relevant_neighbours,
@@ -132,7 +139,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -159,16 +166,35 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        compute_pdb(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    int num_new_patterns = new_patterns.size();
+    PDBCollection new_pdbs(num_new_patterns);
+    atomic<bool> timeout(false);
+    thread_pool->parallel_for(
+        num_new_patterns,
+        [&](int i) {
+            if (timeout || hill_climbing_timer->is_expired()) {
+                timeout = true;
+                return;
+            }
+            new_pdbs[i] = compute_pdb(task_proxy, new_patterns[i]);
+        });
+    if (timeout) {
+        throw HillClimbingTimeout();
+    }
+
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb : new_pdbs) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
+    }
     return max_pdb_size;
 }
 
@@ -191,9 +217,41 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
     }
 }
 
+void PatternCollectionGeneratorHillclimbing::compute_sample_matrix(
+    const vector<State> &samples, SampleMatrix &sample_matrix) const {
+    int num_vars = samples.empty() ? 0 : samples[0].size();
+    vector<vector<int>> &values_by_var = sample_matrix.values_by_var;
+    values_by_var.assign(num_vars, vector<int>(samples.size()));
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i].unpack();
+        const vector<int> &values = samples[i].get_unpacked_values();
+        for (int var = 0; var < num_vars; ++var) {
+            values_by_var[var][i] = values[var];
+        }
+    }
+
+    sample_matrix.collection_h_values.clear();
+    for (const State &sample : samples) {
+        sample_matrix.collection_h_values.push_back(current_pdbs->get_value(sample));
+    }
+
+    const PDBCollection &pdbs = *current_pdbs->get_pattern_databases();
+    sample_matrix.pdb_h_values.resize(pdbs.size());
+    thread_pool->parallel_for(
+        pdbs.size(),
+        [&](int pdb_index) {
+            vector<int> &h_values = sample_matrix.pdb_h_values[pdb_index];
+            pdbs[pdb_index]->get_values(values_by_var, h_values);
+            for (int &h : h_values) {
+                if (h == numeric_limits<int>::max()) {
+                    h = 0;
+                }
+            }
+        });
+}
+
 pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
-    const vector<State> &samples,
-    const vector<int> &samples_h_values,
+    const SampleMatrix &sample_matrix,
     PDBCollection &candidate_pdbs) {
     /*
       TODO: The original implementation by Haslum et al. uses A* to compute
@@ -202,53 +260,59 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
       We require that a pattern must have an improvement of at least one in
       order to be taken into account.
     */
-    int improvement = 0;
-    int best_pdb_index = -1;
-
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
+    int num_candidates = candidate_pdbs.size();
+    for (int i = 0; i < num_candidates; ++i) {
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
-        }
         /*
           If a candidate's size added to the current collection's size exceeds
           the maximum collection size, then forget the pdb.
         */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
+        if (pdb &&
+            current_pdbs->get_size() + pdb->get_size() > collection_max_size) {
             candidate_pdbs[i] = nullptr;
-            continue;
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    // Evaluate all candidates in parallel, storing the count of candidate i at position i.
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timeout(false);
+    thread_pool->parallel_for(
+        num_candidates,
+        [&](int i) {
+            if (timeout || hill_climbing_timer->is_expired()) {
+                timeout = true;
+                return;
             }
-        }
+            const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+            if (!pdb) {
+                /* candidate pattern is too large or has already been added to
+                   the canonical heuristic. */
+                return;
+            }
+
+            /*
+              Calculate the "counting approximation" for all sample states: count
+              the number of samples for which the current pattern collection
+              heuristic would be improved if the new pattern was included into it.
+            */
+            /*
+              TODO: The original implementation by Haslum et al. uses m/t as a
+              statistical confidence interval to stop the A*-search (which they use,
+              see above) earlier.
+            */
+            vector<PatternClique> pattern_cliques =
+                current_pdbs->get_pattern_cliques(pdb->get_pattern());
+            counts[i] = count_improved_samples(*pdb, pattern_cliques, sample_matrix);
+        });
+    if (timeout) {
+        throw HillClimbingTimeout();
+    }
+
+    // Iterate over all candidates and search for the best improving pattern/pdb
+    int improvement = 0;
+    int best_pdb_index = -1;
+    for (int i = 0; i < num_candidates; ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -262,48 +326,60 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     return make_pair(improvement, best_pdb_index);
 }
 
-bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
-    const vector<int> &sample_data = sample.get_unpacked_values();
+int PatternCollectionGeneratorHillclimbing::count_improved_samples(
+    const PatternDatabase &pdb, const vector<PatternClique> &pattern_cliques,
+    const SampleMatrix &sample_matrix) const {
+    const int infinity = numeric_limits<int>::max();
+    int num_sample_states = sample_matrix.collection_h_values.size();
+    const int *collection_h_values = sample_matrix.collection_h_values.data();
+
     // h_pattern: h-value of the new pattern
-    int h_pattern = pdb.get_value(sample_data);
+    vector<int> pattern_h_values;
+    pdb.get_values(sample_matrix.values_by_var, pattern_h_values);
+    const int *pattern_h = pattern_h_values.data();
 
-    if (h_pattern == numeric_limits<int>::max()) {
-        return true;
+    if (pattern_cliques.empty()) {
+        return count(pattern_h_values.begin(), pattern_h_values.end(), infinity);
     }
 
-    // h_collection: h-value of the current collection heuristic
-    if (h_collection == numeric_limits<int>::max())
-        return false;
-
-    vector<int> h_values;
-    h_values.reserve(pdbs.size());
-    for (const shared_ptr<PatternDatabase> &p : pdbs) {
-        int h = p->get_value(sample_data);
-        if (h == numeric_limits<int>::max())
-            return false;
-        h_values.push_back(h);
-    }
-    for (const PatternClique &clilque : pattern_cliques) {
-        int h_clique = 0;
-        for (PatternID pattern_id : clilque) {
-            h_clique += h_values[pattern_id];
+    // Maximum h-value over the pattern cliques for each sample.
+    vector<int> max_clique_h_values(num_sample_states, 0);
+    vector<int> clique_h_values(num_sample_states);
+    int *max_clique_h = max_clique_h_values.data();
+    int *clique_h = clique_h_values.data();
+    for (const PatternClique &clique : pattern_cliques) {
+        fill(clique_h_values.begin(), clique_h_values.end(), 0);
+        for (PatternID pattern_id : clique) {
+            const int *pdb_h = sample_matrix.pdb_h_values[pattern_id].data();
+            for (int i = 0; i < num_sample_states; ++i) {
+                clique_h[i] += pdb_h[i];
+            }
         }
-        if (h_pattern + h_clique > h_collection) {
-            /*
-              return true if a pattern clique is found for
-              which the condition is met
-            */
-            return true;
+        for (int i = 0; i < num_sample_states; ++i) {
+            max_clique_h[i] = max(max_clique_h[i], clique_h[i]);
         }
     }
-    return false;
+
+    /*
+      A sample is improved if the new pattern detects a dead end or if
+      h_pattern + h_clique > h_collection for some clique. The latter is
+      written as a subtraction to avoid overflows for infinite values.
+    */
+    int count = 0;
+    for (int i = 0; i < num_sample_states; ++i) {
+        int h_collection = collection_h_values[i];
+        bool is_dead_end = pattern_h[i] == infinity;
+        bool is_improved = h_collection != infinity &&
+            max_clique_h[i] > h_collection - pattern_h[i];
+        count += is_dead_end || is_improved;
+    }
+    return count;
 }
 
 void PatternCollectionGeneratorHillclimbing::hill_climbing(
     const TaskProxy &task_proxy) {
     hill_climbing_timer = new utils::CountdownTimer(max_time);
+    thread_pool = utils::make_unique_ptr<utils::ThreadPool>(num_threads);
 
     if (log.is_at_least_normal()) {
         log << "Average operator cost: "
@@ -320,30 +396,31 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     PDBCollection candidate_pdbs;
     // The maximum size over all PDBs in candidate_pdbs.
     int max_pdb_size = 0;
-    for (const shared_ptr<PatternDatabase> &current_pdb :
-         *(current_pdbs->get_pattern_databases())) {
-        int new_max_pdb_size = generate_candidate_pdbs(
-            task_proxy, relevant_neighbours, *current_pdb, generated_patterns,
-            candidate_pdbs);
-        max_pdb_size = max(max_pdb_size, new_max_pdb_size);
-    }
-    /*
-      NOTE: The initial set of candidate patterns (in generated_patterns) is
-      guaranteed to be "normalized" in the sense that there are no duplicates
-      and patterns are sorted.
-    */
-    if (log.is_at_least_normal()) {
-        log << "Done calculating initial candidate PDBs" << endl;
-    }
 
     int num_iterations = 0;
     State initial_state = task_proxy.get_initial_state();
 
     sampling::RandomWalkSampler sampler(task_proxy, *rng);
     vector<State> samples;
-    vector<int> samples_h_values;
+    SampleMatrix sample_matrix;
 
     try {
+        for (const shared_ptr<PatternDatabase> &current_pdb :
+             *(current_pdbs->get_pattern_databases())) {
+            int new_max_pdb_size = generate_candidate_pdbs(
+                task_proxy, relevant_neighbours, *current_pdb, generated_patterns,
+                candidate_pdbs);
+            max_pdb_size = max(max_pdb_size, new_max_pdb_size);
+        }
+        /*
+          NOTE: The initial set of candidate patterns (in generated_patterns) is
+          guaranteed to be "normalized" in the sense that there are no duplicates
+          and patterns are sorted.
+        */
+        if (log.is_at_least_normal()) {
+            log << "Done calculating initial candidate PDBs" << endl;
+        }
+
         while (true) {
             ++num_iterations;
             int init_h = current_pdbs->get_value(initial_state);
@@ -363,14 +440,11 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
             }
 
             samples.clear();
-            samples_h_values.clear();
             sample_states(sampler, init_h, samples);
-            for (const State &sample : samples) {
-                samples_h_values.push_back(current_pdbs->get_value(sample));
-            }
+            compute_sample_matrix(samples, sample_matrix);
 
             pair<int, int> improvement_and_index =
-                find_best_improving_pdb(samples, samples_h_values, candidate_pdbs);
+                find_best_improving_pdb(sample_matrix, candidate_pdbs);
             int improvement = improvement_and_index.first;
             int best_pdb_index = improvement_and_index.second;
 
@@ -428,6 +502,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
 
     delete hill_climbing_timer;
     hill_climbing_timer = nullptr;
+    thread_pool = nullptr;
 }
 
 string PatternCollectionGeneratorHillclimbing::name() const {
@@ -551,6 +626,13 @@ void add_hillclimbing_options(plugins::Feature &feature) {
         "spent for pruning dominated patterns.",
         "infinity",
         plugins::Bounds("0.0", "infinity"));
+    feature.add_option<int>(
+        "num_threads",
+        "number of threads used to compute and evaluate the candidate PDBs. "
+        "The resulting pattern collection does not depend on the number of "
+        "threads unless hill climbing is stopped by max_time.",
+        "1",
+        plugins::Bounds("1", "infinity"));
     utils::add_rng_options(feature);
     add_generator_options_to_feature(feature);
 }
@@ -660,6 +742,11 @@ public:
             "patterns", pgh);
         heuristic_opts.set<double>(
             "max_time_dominance_pruning", options.get<double>("max_time_dominance_pruning"));
+        heuristic_opts.set<bool>(
+            "compress_distances", options.get<bool>("compress_distances"));
+        // Hill climbing computes explicit PDBs for all patterns.
+        heuristic_opts.set<PDBRepresentation>(
+            "representation", PDBRepresentation::EXPLICIT);
 
         return make_shared<CanonicalPDBsHeuristic>(heuristic_opts);
     }
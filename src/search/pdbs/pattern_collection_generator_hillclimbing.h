@@ -14,6 +14,7 @@
 namespace utils {
 class CountdownTimer;
 class RandomNumberGenerator;
+class ThreadPool;
 }
 
 namespace sampling {
@@ -35,6 +36,7 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
@@ -42,6 +44,25 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // for stats only
     int num_rejected;
     utils::CountdownTimer *hill_climbing_timer;
+    // Used to compute and evaluate the candidate PDBs in parallel.
+    std::unique_ptr<utils::ThreadPool> thread_pool;
+
+    /*
+      The sample states of a hill climbing iteration in column-major form
+      (values_by_var[var][i] is the value of var in the i-th sample) and
+      the h values of the current pattern collection for them.
+    */
+    struct SampleMatrix {
+        std::vector<std::vector<int>> values_by_var;
+        std::vector<int> collection_h_values;
+        /*
+          pdb_h_values[p][i] is the h value of the p-th PDB of the current
+          collection for the i-th sample. Infinite values are replaced by
+          0. This is safe because these values are only used for samples
+          with a finite collection h value, where all PDBs are finite.
+        */
+        std::vector<std::vector<int>> pdb_h_values;
+    };
 
     /*
       For the given PDB, all possible extensions of its pattern by one
@@ -50,6 +71,11 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       generated_patterns) and if building a PDB for it does not surpass the
       size limit, then the PDB is built and added to candidate_pdbs.
 
+      The PDBs are built in parallel, but added to candidate_pdbs in the
+      order of their patterns, so the result does not depend on the number
+      of threads. Throws HillClimbingTimeout if the hill climbing timer
+      expires.
+
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
     int generate_candidate_pdbs(
@@ -74,28 +100,34 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
         int init_h,
         std::vector<State> &samples);
 
+    void compute_sample_matrix(
+        const std::vector<State> &samples, SampleMatrix &sample_matrix) const;
+
     /*
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      The candidates are evaluated in parallel. Ties are broken in favor of
+      the candidate with the smallest index, like in a sequential evaluation.
     */
     std::pair<int, int> find_best_improving_pdb(
-        const std::vector<State> &samples,
-        const std::vector<int> &samples_h_values,
+        const SampleMatrix &sample_matrix,
         PDBCollection &candidate_pdbs);
 
     /*
-      Returns true iff the h-value of the new pattern (from pdb) plus the
-      h-value of all pattern cliques from the current pattern
-      collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      Returns the number of samples for which the h-value of the new pattern
+      (from pdb) plus the h-value of one of the pattern cliques from the
+      current pattern collection heuristic if the new pattern was added to it
+      is greater than the h-value of the current pattern collection. Samples
+      that are dead ends for the new pattern always count as improved.
+
+      All samples are processed at once, with loops over contiguous arrays.
     */
-    bool is_heuristic_improved(
+    int count_improved_samples(
         const PatternDatabase &pdb,
-        const State &sample,
-        int h_collection,
-        const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        const std::vector<PatternClique> &pattern_cliques,
+        const SampleMatrix &sample_matrix) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
@@ -133,7 +165,7 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
         const std::shared_ptr<AbstractTask> &task) override;
 public:
     explicit PatternCollectionGeneratorHillclimbing(const plugins::Options &opts);
-    virtual ~PatternCollectionGeneratorHillclimbing() = default;
+    virtual ~PatternCollectionGeneratorHillclimbing() override;
 };
 }
 
@@ -50,6 +50,10 @@ public:
         return task_proxy;
     }
 
+    bool has_pdbs() const {
+        return pdbs != nullptr;
+    }
+
     std::shared_ptr<PatternCollection> get_patterns() const;
     std::shared_ptr<PDBCollection> get_pdbs();
     std::shared_ptr<std::vector<PatternClique>> get_pattern_cliques();
@@ -1,10 +1,13 @@
 #include "pattern_database.h"
 
+#include "decision_diagram.h"
+
 #include "../task_utils/task_properties.h"
 
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -41,36 +44,181 @@ Projection::Projection(
     }
 }
 
-int Projection::rank(const vector<int> &state) const {
-    size_t index = 0;
-    for (size_t i = 0; i < pattern.size(); ++i) {
-        index += hash_multipliers[i] * state[pattern[i]];
-    }
-    return index;
-}
-
 int Projection::unrank(int index, int var) const {
     int temp = index / hash_multipliers[var];
     return temp % domain_sizes[var];
 }
 
+// Return the log of the smallest width whose sentinel is larger than value.
+static int get_bits_per_entry_log(int value) {
+    int bits_per_entry_log = 1;
+    while (bits_per_entry_log < 5 &&
+           static_cast<uint64_t>(value) >=
+           (uint64_t(1) << (1 << bits_per_entry_log)) - 1) {
+        ++bits_per_entry_log;
+    }
+    return bits_per_entry_log;
+}
+
+DistanceTable::DistanceTable(int num_entries)
+    : num_entries(num_entries),
+      max_finite_value(0),
+      contains_infinity(num_entries > 0),
+      bits_per_entry_log(1),
+      entries_per_word_log(5),
+      entry_mask(3) {
+    int entries_per_word = 1 << entries_per_word_log;
+    // All bits set means that all entries are infinity.
+    words.assign((num_entries + entries_per_word - 1) / entries_per_word,
+                 numeric_limits<uint64_t>::max());
+}
+
+void DistanceTable::set_width(int new_bits_per_entry_log) {
+    int new_entries_per_word_log = 6 - new_bits_per_entry_log;
+    int new_entries_per_word = 1 << new_entries_per_word_log;
+    uint64_t new_entry_mask =
+        (uint64_t(1) << (1 << new_bits_per_entry_log)) - 1;
+    vector<uint64_t> new_words(
+        (num_entries + new_entries_per_word - 1) / new_entries_per_word, 0);
+    for (int index = 0; index < num_entries; ++index) {
+        uint64_t value = get_entry(index);
+        if (value == entry_mask) {
+            value = new_entry_mask;
+        }
+        int entry_in_word = index & (new_entries_per_word - 1);
+        new_words[index >> new_entries_per_word_log] |=
+            value << (entry_in_word << new_bits_per_entry_log);
+    }
+    words.swap(new_words);
+    bits_per_entry_log = new_bits_per_entry_log;
+    entries_per_word_log = new_entries_per_word_log;
+    entry_mask = new_entry_mask;
+}
+
+void DistanceTable::widen(int value) {
+    int new_bits_per_entry_log = get_bits_per_entry_log(value);
+    assert(new_bits_per_entry_log > bits_per_entry_log);
+    set_width(new_bits_per_entry_log);
+}
+
+void DistanceTable::finalize() {
+    max_finite_value = 0;
+    contains_infinity = false;
+    for (int index = 0; index < num_entries; ++index) {
+        int value = get(index);
+        if (value == numeric_limits<int>::max()) {
+            contains_infinity = true;
+        } else {
+            max_finite_value = max(max_finite_value, value);
+        }
+    }
+    int min_bits_per_entry_log = get_bits_per_entry_log(max_finite_value);
+    if (min_bits_per_entry_log < bits_per_entry_log) {
+        set_width(min_bits_per_entry_log);
+    }
+}
+
 PatternDatabase::PatternDatabase(
     Projection &&projection,
-    vector<int> &&distances)
+    DistanceTable &&distances)
     : projection(move(projection)),
-      distances(move(distances)) {
+      storage(DistanceStorage::TABLE),
+      distances(move(distances)),
+      max_finite_h(this->distances.get_max_finite_value()),
+      contains_dead_ends(this->distances.has_infinite_values()) {
 }
 
-int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[projection.rank(state)];
+PatternDatabase::PatternDatabase(
+    Projection &&projection,
+    unique_ptr<DistanceDiagram> &&distance_diagram)
+    : projection(move(projection)),
+      storage(DistanceStorage::DIAGRAM),
+      distance_diagram(move(distance_diagram)),
+      max_finite_h(this->distance_diagram->compute_max_finite_h()),
+      contains_dead_ends(this->distance_diagram->has_dead_ends()) {
+}
+
+PatternDatabase::~PatternDatabase() {
+}
+
+int PatternDatabase::get_diagram_value(const vector<int> &state) const {
+    return distance_diagram->evaluate(
+        [&](int var) {return state[var];});
+}
+
+int PatternDatabase::get_distance(int index) const {
+    assert(storage != DistanceStorage::DIAGRAM);
+    if (storage == DistanceStorage::UNCOMPRESSED_TABLE) {
+        return uncompressed_distances[index];
+    }
+    return distances.get(index);
+}
+
+void PatternDatabase::uncompress_distances() {
+    if (storage != DistanceStorage::TABLE) {
+        return;
+    }
+    uncompressed_distances.resize(distances.size());
+    for (int index = 0; index < distances.size(); ++index) {
+        uncompressed_distances[index] = distances.get(index);
+    }
+    distances = DistanceTable();
+    storage = DistanceStorage::UNCOMPRESSED_TABLE;
+}
+
+void PatternDatabase::get_values(
+    const vector<vector<int>> &values_by_var, vector<int> &values) const {
+    const Pattern &pattern = projection.get_pattern();
+    assert(!pattern.empty());
+    int num_states = values_by_var[pattern[0]].size();
+    if (storage == DistanceStorage::DIAGRAM) {
+        values.resize(num_states);
+        for (int state = 0; state < num_states; ++state) {
+            values[state] = distance_diagram->evaluate(
+                [&](int var) {return values_by_var[var][state];});
+        }
+        return;
+    }
+    values.assign(num_states, 0);
+    int *ranks = values.data();
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        int multiplier = projection.get_multiplier(i);
+        const int *var_values = values_by_var[pattern[i]].data();
+        for (int state = 0; state < num_states; ++state) {
+            ranks[state] += multiplier * var_values[state];
+        }
+    }
+    if (storage == DistanceStorage::UNCOMPRESSED_TABLE) {
+        for (int state = 0; state < num_states; ++state) {
+            values[state] = uncompressed_distances[ranks[state]];
+        }
+    } else {
+        for (int state = 0; state < num_states; ++state) {
+            values[state] = distances.get(ranks[state]);
+        }
+    }
+}
+
+int64_t PatternDatabase::get_size_in_bytes() const {
+    int64_t size = distances.get_size_in_bytes() +
+        uncompressed_distances.size() * sizeof(int) +
+        3 * get_pattern().size() * sizeof(int);
+    if (distance_diagram) {
+        size += distance_diagram->get_size_in_bytes();
+    }
+    return size;
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
+    if (storage == DistanceStorage::DIAGRAM) {
+        return distance_diagram->compute_mean_finite_h();
+    }
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    for (int i = 0; i < get_size(); ++i) {
+        int h = get_distance(i);
+        if (h != numeric_limits<int>::max()) {
+            sum += h;
             ++size;
         }
     }
@@ -5,9 +5,15 @@
 
 #include "../task_proxy.h"
 
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 namespace pdbs {
+class DistanceDiagram;
+
 class Projection {
     Pattern pattern;
     std::vector<int> domain_sizes;
@@ -17,7 +23,13 @@ public:
     Projection(const TaskProxy &task_proxy, const Pattern &pattern);
 
     // Compute the hash index (aka. the rank) of the given concrete state.
-    int rank(const std::vector<int> &state) const;
+    int rank(const std::vector<int> &state) const {
+        size_t index = 0;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            index += hash_multipliers[i] * state[pattern[i]];
+        }
+        return index;
+    }
 
     /*
       Compute the value of a given variable in the abstract state given as
@@ -36,21 +48,189 @@ public:
     int get_multiplier(int var) const {
         return hash_multipliers[var];
     }
+
+    int get_domain_size(int var) const {
+        return domain_sizes[var];
+    }
+};
+
+/*
+  Compressed table of the goal distances of all abstract states.
+
+  Every entry uses the smallest width out of 2, 4, 8, 16 and 32 bits that
+  can represent all finite distances plus a sentinel for infinity (the
+  largest representable value). Since these widths divide 64, no entry
+  spans two words, and a lookup is a shift and a mask. For example, the
+  distances of a PDB for a unit-cost task with a maximal finite distance
+  of at most 14 need only 4 bits per abstract state.
+
+  The table is filled in place while the distances are computed: it
+  starts with all entries set to infinity and the smallest width, and
+  set() doubles the width whenever a value does not fit. Once all values
+  are final, finalize() switches to the smallest width that fits the
+  final values, since intermediate values can be larger.
+*/
+class DistanceTable {
+    int num_entries;
+    int max_finite_value;
+    bool contains_infinity;
+    int bits_per_entry_log;
+    int entries_per_word_log;
+    uint64_t entry_mask;
+    std::vector<uint64_t> words;
+
+    uint64_t get_entry(int index) const {
+        uint64_t word = words[index >> entries_per_word_log];
+        int entry_in_word = index & ((1 << entries_per_word_log) - 1);
+        return (word >> (entry_in_word << bits_per_entry_log)) & entry_mask;
+    }
+
+    void set_width(int new_bits_per_entry_log);
+    // Increase the width of all entries so that the given value fits.
+    void widen(int value);
+public:
+    // Create a table with num_entries entries that are all infinity.
+    explicit DistanceTable(int num_entries = 0);
+
+    // Infinity is given as numeric_limits<int>::max().
+    int get(int index) const {
+        assert(index >= 0 && index < num_entries);
+        uint64_t value = get_entry(index);
+        if (value == entry_mask) {
+            return std::numeric_limits<int>::max();
+        }
+        return static_cast<int>(value);
+    }
+
+    void set(int index, int value) {
+        assert(index >= 0 && index < num_entries);
+        assert(value >= 0 && value != std::numeric_limits<int>::max());
+        if (static_cast<uint64_t>(value) >= entry_mask) {
+            widen(value);
+        }
+        uint64_t &word = words[index >> entries_per_word_log];
+        int shift = (index & ((1 << entries_per_word_log) - 1)) << bits_per_entry_log;
+        word = (word & ~(entry_mask << shift)) |
+            (static_cast<uint64_t>(value) << shift);
+    }
+
+    /*
+      Compute the maximal finite value and whether there are infinite
+      entries, and use the smallest width that fits all values.
+    */
+    void finalize();
+
+    int size() const {
+        return num_entries;
+    }
+
+    // Only valid after finalize(). Return 0 if there are no finite entries.
+    int get_max_finite_value() const {
+        return max_finite_value;
+    }
+
+    // Only valid after finalize().
+    bool has_infinite_values() const {
+        return contains_infinity;
+    }
+
+    int64_t get_size_in_bytes() const {
+        return words.size() * sizeof(uint64_t);
+    }
+};
+
+/*
+  The goal distances are either stored explicitly in a DistanceTable,
+  explicitly in a plain vector with one int per abstract state (see
+  PatternDatabase::uncompress_distances()), or symbolically in a
+  DistanceDiagram (see symbolic_pdb_factory.h).
+*/
+enum class DistanceStorage {
+    TABLE,
+    UNCOMPRESSED_TABLE,
+    DIAGRAM
 };
 
+/*
+  All methods work with all kinds of distance storage. Callers that
+  evaluate many PDBs with the same storage, such as CanonicalPDBs, can
+  look up the storage once and pass it to get_value() as a template
+  argument, which avoids checking the storage for every lookup.
+*/
 class PatternDatabase {
     Projection projection;
+    DistanceStorage storage;
 
     /*
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
+      Only one of the three members is used, depending on the storage.
     */
-    std::vector<int> distances;
+    DistanceTable distances;
+    std::vector<int> uncompressed_distances;
+    std::unique_ptr<DistanceDiagram> distance_diagram;
+
+    // Computed once when the PDB is built.
+    int max_finite_h;
+    bool contains_dead_ends;
+
+    int get_diagram_value(const std::vector<int> &state) const;
+    int get_distance(int index) const;
 public:
+    // The distance table must be finalized.
+    PatternDatabase(
+        Projection &&projection,
+        DistanceTable &&distances);
     PatternDatabase(
         Projection &&projection,
-        std::vector<int> &&distances);
-    int get_value(const std::vector<int> &state) const;
+        std::unique_ptr<DistanceDiagram> &&distance_diagram);
+    ~PatternDatabase();
+
+    DistanceStorage get_distance_storage() const {
+        return storage;
+    }
+
+    template<DistanceStorage storage>
+    int get_value(const std::vector<int> &state) const {
+        assert(storage == get_distance_storage());
+        if constexpr (storage == DistanceStorage::TABLE) {
+            return distances.get(projection.rank(state));
+        } else if constexpr (storage == DistanceStorage::UNCOMPRESSED_TABLE) {
+            return uncompressed_distances[projection.rank(state)];
+        } else {
+            return get_diagram_value(state);
+        }
+    }
+
+    int get_value(const std::vector<int> &state) const {
+        switch (storage) {
+        case DistanceStorage::TABLE:
+            return get_value<DistanceStorage::TABLE>(state);
+        case DistanceStorage::UNCOMPRESSED_TABLE:
+            return get_value<DistanceStorage::UNCOMPRESSED_TABLE>(state);
+        case DistanceStorage::DIAGRAM:
+            return get_value<DistanceStorage::DIAGRAM>(state);
+        }
+        assert(false);
+        return 0;
+    }
+
+    /*
+      Store the distances of an explicit PDB with one int per abstract
+      state. Lookups then need no shift and mask, but the distances use
+      up to 16 times as much memory.
+    */
+    void uncompress_distances();
+
+    /*
+      Compute the values of many states at once. The states are given in
+      column-major form, i.e., values_by_var[var][i] is the value of var
+      in the i-th state. The ranks are computed column by column, so the
+      inner loops run over contiguous arrays.
+    */
+    void get_values(
+        const std::vector<std::vector<int>> &values_by_var,
+        std::vector<int> &values) const;
 
     const Pattern &get_pattern() const {
         return projection.get_pattern();
@@ -61,6 +241,9 @@ public:
         return projection.get_num_abstract_states();
     }
 
+    // Approximate memory usage (dominated by the distances).
+    int64_t get_size_in_bytes() const;
+
     /*
       Return the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
@@ -70,6 +253,18 @@ public:
       this method!
     */
     double compute_mean_finite_h() const;
+
+    /*
+      Return the maximal h-value over all states that are not dead-ends
+      (0 if all states are dead-ends).
+    */
+    int get_max_finite_h() const {
+        return max_finite_h;
+    }
+
+    bool has_dead_ends() const {
+        return contains_dead_ends;
+    }
 };
 }
 
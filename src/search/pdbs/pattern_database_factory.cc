@@ -1,12 +1,14 @@
 #include "pattern_database_factory.h"
 
 #include "abstract_operator.h"
-#include "match_tree.h"
 #include "pattern_database.h"
+#include "pdb_cache.h"
+#include "regression_operator_index.h"
 
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/math.h"
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 
 #include <algorithm>
@@ -24,7 +26,7 @@ class PatternDatabaseFactory {
     vector<int> variable_to_index;
     vector<AbstractOperator> abstract_ops;
     vector<FactPair> abstract_goals;
-    vector<int> distances;
+    DistanceTable distances;
     vector<int> generating_op_ids;
     vector<vector<OperatorID>> wildcard_plan;
 
@@ -74,15 +76,37 @@ class PatternDatabaseFactory {
     void compute_abstract_operators(const vector<int> &operator_costs);
 
     /*
-      This creates a unique_ptr because MSVC 14.29 leaves MatchTree in
-      an invalid state when using raw objects here, presumably because
-      it cannot create a correct default move assignment operator for the
-      Node class used by MatchTree.
+      Add the abstract operators of the given operator of a base projection
+      with hash multipliers base_multipliers to abstract_ops. Preconditions
+      are mapped to the pattern of this projection with base_to_index.
     */
-    unique_ptr<MatchTree> compute_match_tree() const;
+    void add_base_abstract_operator(
+        const AbstractOperator &base_op,
+        const vector<int> &base_multipliers,
+        const vector<int> &base_to_index);
+
+    /*
+      Compute the same abstract operators as compute_abstract_operators()
+      does for the original operator costs, but derive the abstract
+      operators of each concrete operator that only mentions variables of
+      a single base projection from the abstract operators of the base
+      projection.
+    */
+    void compute_abstract_operators_from_base_projections(
+        const vector<const ProjectionOperators *> &base_projections,
+        const vector<vector<int>> &operators_by_variable);
 
     void compute_abstract_goals();
 
+    // Compute the values of all pattern variables in the given abstract state.
+    void unrank(int state_index, vector<int> &state_values) const;
+
+    /*
+      Enumerate all abstract goal states in increasing order by iterating
+      over the values of the non-goal variables with their strides.
+    */
+    vector<int> compute_goal_states() const;
+
     /*
       For a given abstract state (given as index), the according values
       for each variable in the state are computed and compared with the
@@ -91,10 +115,36 @@ class PatternDatabaseFactory {
     */
     bool is_goal_state(int state_index) const;
 
-    void compute_distances(const MatchTree &match_tree, bool compute_plan);
+    /*
+      Return the cost of all abstract operators if they all have the same
+      positive cost and -1 otherwise.
+    */
+    int get_uniform_operator_cost() const;
+
+    /*
+      Compute the goal distances with a layered breadth-first search if
+      all operators have the same positive cost and with Dijkstra's
+      algorithm (using a bucket-based queue) otherwise. The distances are
+      written directly into the compressed table, so we never store one
+      int per abstract state.
+    */
+    void compute_distances(
+        const RegressionOperatorIndex &operator_index, bool compute_plan);
+    void compute_distances_by_layers(
+        const RegressionOperatorIndex &operator_index, int operator_cost,
+        vector<int> &&goal_states, bool compute_plan);
+    void compute_distances_with_dijkstra(
+        const RegressionOperatorIndex &operator_index,
+        const vector<int> &goal_states, bool compute_plan);
 
     void compute_plan(
-        const MatchTree &match_tree,
+        const RegressionOperatorIndex &operator_index,
+        const shared_ptr<utils::RandomNumberGenerator> &rng,
+        bool compute_wildcard_plan);
+
+    // Compute the distances (and plan) once the abstract operators are known.
+    void compute_distances_and_plan(
+        bool compute_plan,
         const shared_ptr<utils::RandomNumberGenerator> &rng,
         bool compute_wildcard_plan);
 public:
@@ -105,6 +155,14 @@ public:
         bool compute_plan = false,
         const shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
         bool compute_wildcard_plan = false);
+    // Always computes a plan and uses the original operator costs.
+    PatternDatabaseFactory(
+        const TaskProxy &task_proxy,
+        const Pattern &pattern,
+        const vector<const ProjectionOperators *> &base_projections,
+        const vector<vector<int>> &operators_by_variable,
+        const shared_ptr<utils::RandomNumberGenerator> &rng,
+        bool compute_wildcard_plan);
     ~PatternDatabaseFactory() = default;
 
     shared_ptr<PatternDatabase> extract_pdb() {
@@ -116,6 +174,10 @@ public:
     vector<vector<OperatorID>> && extract_wildcard_plan() {
         return move(wildcard_plan);
     };
+
+    vector<AbstractOperator> && extract_abstract_operators() {
+        return move(abstract_ops);
+    }
 };
 
 void PatternDatabaseFactory::compute_variable_to_index(const Pattern &pattern) {
@@ -135,7 +197,7 @@ AbstractOperator PatternDatabaseFactory::build_abstract_operator(
     regression_preconditions.insert(regression_preconditions.end(),
                                     eff_pairs.begin(),
                                     eff_pairs.end());
-    // Sort preconditions for MatchTree construction.
+    // Sort preconditions for RegressionOperatorIndex construction.
     sort(regression_preconditions.begin(), regression_preconditions.end());
     for (size_t i = 1; i < regression_preconditions.size(); ++i) {
         assert(regression_preconditions[i].var !=
@@ -262,13 +324,106 @@ void PatternDatabaseFactory::compute_abstract_operators(
     }
 }
 
-unique_ptr<MatchTree> PatternDatabaseFactory::compute_match_tree() const {
-    unique_ptr<MatchTree> match_tree = utils::make_unique_ptr<MatchTree>(task_proxy, projection);
-    for (size_t op_id = 0; op_id < abstract_ops.size(); ++op_id) {
-        const AbstractOperator &op = abstract_ops[op_id];
-        match_tree->insert(op_id, op.get_regression_preconditions());
+void PatternDatabaseFactory::add_base_abstract_operator(
+    const AbstractOperator &base_op,
+    const vector<int> &base_multipliers,
+    const vector<int> &base_to_index) {
+    /*
+      The hash effect is the sum of (pre - post) * multiplier over the
+      effect variables. The post values are the regression preconditions
+      on these variables, and the regression preconditions on the other
+      variables are prevail conditions, for which pre == post. Adding the
+      base rank of all regression preconditions to the hash effect thus
+      yields the base rank of the progression preconditions (with value 0
+      for all other variables), from which we read off the pre values.
+    */
+    int pre_rank = base_op.get_hash_effect();
+    for (const FactPair &fact : base_op.get_regression_preconditions()) {
+        pre_rank += fact.value * base_multipliers[fact.var];
+    }
+    vector<FactPair> regression_preconditions;
+    regression_preconditions.reserve(
+        base_op.get_regression_preconditions().size());
+    int hash_effect = 0;
+    for (const FactPair &fact : base_op.get_regression_preconditions()) {
+        int var = base_to_index[fact.var];
+        int domain_size = projection.get_domain_size(var);
+        int pre_value = (pre_rank / base_multipliers[fact.var]) % domain_size;
+        hash_effect += (pre_value - fact.value) * projection.get_multiplier(var);
+        /* The mapping of pattern indices is monotonic, so the
+           preconditions stay sorted. */
+        regression_preconditions.emplace_back(var, fact.value);
+    }
+    abstract_ops.emplace_back(
+        base_op.get_concrete_op_id(), base_op.get_cost(),
+        move(regression_preconditions), hash_effect);
+}
+
+void PatternDatabaseFactory::compute_abstract_operators_from_base_projections(
+    const vector<const ProjectionOperators *> &base_projections,
+    const vector<vector<int>> &operators_by_variable) {
+    const Pattern &pattern = projection.get_pattern();
+    int num_bases = base_projections.size();
+    vector<vector<int>> base_multipliers(num_bases);
+    vector<vector<int>> base_to_index(num_bases);
+    vector<int> index_to_base(pattern.size(), -1);
+    for (int base_id = 0; base_id < num_bases; ++base_id) {
+        int multiplier = 1;
+        for (int var_id : base_projections[base_id]->pattern) {
+            int index = variable_to_index[var_id];
+            assert(index != -1 && index_to_base[index] == -1);
+            index_to_base[index] = base_id;
+            base_multipliers[base_id].push_back(multiplier);
+            base_to_index[base_id].push_back(index);
+            multiplier *= projection.get_domain_size(index);
+        }
+    }
+
+    /*
+      For every concrete operator, determine the base projection whose
+      abstract operators we can reuse (>= 0), or whether we have to build
+      the abstract operators (REBUILD) or can skip the operator because it
+      mentions no pattern variable (UNUSED).
+    */
+    const int UNUSED = -1;
+    const int REBUILD = -2;
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<int> operator_sources(operators.size(), UNUSED);
+    for (size_t index = 0; index < pattern.size(); ++index) {
+        int source = (index_to_base[index] == -1) ? REBUILD : index_to_base[index];
+        for (int op_id : operators_by_variable[pattern[index]]) {
+            int &op_source = operator_sources[op_id];
+            if (op_source == UNUSED) {
+                op_source = source;
+            } else if (op_source != source) {
+                op_source = REBUILD;
+            }
+        }
+    }
+
+    // Base operators are grouped by concrete operator in increasing order.
+    vector<size_t> next_base_op(num_bases, 0);
+    for (int op_id = 0; op_id < static_cast<int>(operators.size()); ++op_id) {
+        int source = operator_sources[op_id];
+        if (source == REBUILD) {
+            OperatorProxy op = operators[op_id];
+            build_abstract_operators_for_op(op, op.get_cost(), abstract_ops);
+        } else if (source != UNUSED) {
+            const vector<AbstractOperator> &base_ops =
+                base_projections[source]->operators;
+            size_t &pos = next_base_op[source];
+            while (pos < base_ops.size() &&
+                   base_ops[pos].get_concrete_op_id() < op_id) {
+                ++pos;
+            }
+            for (; pos < base_ops.size() &&
+                 base_ops[pos].get_concrete_op_id() == op_id; ++pos) {
+                add_base_abstract_operator(
+                    base_ops[pos], base_multipliers[source],
+                    base_to_index[source]);
+            }
+        }
     }
-    return match_tree;
 }
 
 void PatternDatabaseFactory::compute_abstract_goals() {
@@ -292,20 +447,77 @@ bool PatternDatabaseFactory::is_goal_state(int state_index) const {
     return true;
 }
 
-void PatternDatabaseFactory::compute_distances(
-    const MatchTree &match_tree, bool compute_plan) {
-    distances.reserve(projection.get_num_abstract_states());
-    // first implicit entry: priority, second entry: index for an abstract state
-    priority_queues::AdaptiveQueue<int> pq;
+void PatternDatabaseFactory::unrank(
+    int state_index, vector<int> &state_values) const {
+    int num_vars = projection.get_pattern().size();
+    state_values.resize(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        state_values[var] = projection.unrank(state_index, var);
+    }
+}
 
-    // initialize queue
-    for (int state_index = 0; state_index < projection.get_num_abstract_states(); ++state_index) {
-        if (is_goal_state(state_index)) {
-            pq.push(0, state_index);
-            distances.push_back(0);
-        } else {
-            distances.push_back(numeric_limits<int>::max());
+vector<int> PatternDatabaseFactory::compute_goal_states() const {
+    int num_vars = projection.get_pattern().size();
+    vector<bool> is_goal_var(num_vars, false);
+    int first_goal_state = 0;
+    for (const FactPair &goal : abstract_goals) {
+        is_goal_var[goal.var] = true;
+        first_goal_state += goal.value * projection.get_multiplier(goal.var);
+    }
+    vector<int> free_vars;
+    for (int var = 0; var < num_vars; ++var) {
+        if (!is_goal_var[var]) {
+            free_vars.push_back(var);
+        }
+    }
+
+    /*
+      Count through the values of the free variables, starting with the
+      variable with the smallest stride, so that the states are enumerated
+      in increasing order.
+    */
+    vector<int> goal_states;
+    vector<int> free_values(free_vars.size(), 0);
+    int state_index = first_goal_state;
+    while (true) {
+        assert(is_goal_state(state_index));
+        goal_states.push_back(state_index);
+        size_t pos = 0;
+        for (; pos < free_vars.size(); ++pos) {
+            int var = free_vars[pos];
+            state_index += projection.get_multiplier(var);
+            if (++free_values[pos] < projection.get_domain_size(var)) {
+                break;
+            }
+            state_index -= free_values[pos] * projection.get_multiplier(var);
+            free_values[pos] = 0;
         }
+        if (pos == free_vars.size()) {
+            break;
+        }
+    }
+    return goal_states;
+}
+
+int PatternDatabaseFactory::get_uniform_operator_cost() const {
+    if (abstract_ops.empty()) {
+        return 1;
+    }
+    int cost = abstract_ops[0].get_cost();
+    for (const AbstractOperator &op : abstract_ops) {
+        if (op.get_cost() != cost) {
+            return -1;
+        }
+    }
+    return (cost > 0) ? cost : -1;
+}
+
+void PatternDatabaseFactory::compute_distances(
+    const RegressionOperatorIndex &operator_index, bool compute_plan) {
+    distances = DistanceTable(projection.get_num_abstract_states());
+    vector<int> goal_states = compute_goal_states();
+    for (int state_index : goal_states) {
+        distances.set(state_index, 0);
     }
 
     if (compute_plan) {
@@ -322,35 +534,90 @@ void PatternDatabaseFactory::compute_distances(
         generating_op_ids.resize(projection.get_num_abstract_states());
     }
 
-    // Dijkstra loop
+    int operator_cost = get_uniform_operator_cost();
+    if (operator_cost != -1) {
+        compute_distances_by_layers(
+            operator_index, operator_cost, move(goal_states), compute_plan);
+    } else {
+        compute_distances_with_dijkstra(
+            operator_index, goal_states, compute_plan);
+    }
+    distances.finalize();
+}
+
+void PatternDatabaseFactory::compute_distances_by_layers(
+    const RegressionOperatorIndex &operator_index, int operator_cost,
+    vector<int> &&goal_states, bool compute_plan) {
+    /*
+      All states in current_layer have the same distance, so every state
+      reached from them for the first time has its final distance.
+    */
+    vector<int> current_layer = move(goal_states);
+    vector<int> next_layer;
+    vector<int> state_values;
+    int next_distance = operator_cost;
+    while (!current_layer.empty()) {
+        for (int state_index : current_layer) {
+            unrank(state_index, state_values);
+            operator_index.for_each_applicable_operator(
+                state_values,
+                [&](int op_id) {
+                    int predecessor =
+                        state_index + abstract_ops[op_id].get_hash_effect();
+                    if (distances.get(predecessor) == numeric_limits<int>::max()) {
+                        distances.set(predecessor, next_distance);
+                        next_layer.push_back(predecessor);
+                        if (compute_plan) {
+                            generating_op_ids[predecessor] = op_id;
+                        }
+                    }
+                });
+        }
+        current_layer.swap(next_layer);
+        next_layer.clear();
+        next_distance += operator_cost;
+    }
+}
+
+void PatternDatabaseFactory::compute_distances_with_dijkstra(
+    const RegressionOperatorIndex &operator_index,
+    const vector<int> &goal_states, bool compute_plan) {
+    // first implicit entry: priority, second entry: index for an abstract state
+    priority_queues::AdaptiveQueue<int> pq;
+    for (int state_index : goal_states) {
+        pq.push(0, state_index);
+    }
+
+    vector<int> state_values;
     while (!pq.empty()) {
         pair<int, int> node = pq.pop();
         int distance = node.first;
         int state_index = node.second;
-        if (distance > distances[state_index]) {
+        if (distance > distances.get(state_index)) {
             continue;
         }
 
         // regress abstract_state
-        vector<int> applicable_operator_ids;
-        match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
-        for (int op_id : applicable_operator_ids) {
-            const AbstractOperator &op = abstract_ops[op_id];
-            int predecessor = state_index + op.get_hash_effect();
-            int alternative_cost = distances[state_index] + op.get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
-                pq.push(alternative_cost, predecessor);
-                if (compute_plan) {
-                    generating_op_ids[predecessor] = op_id;
+        unrank(state_index, state_values);
+        operator_index.for_each_applicable_operator(
+            state_values,
+            [&](int op_id) {
+                const AbstractOperator &op = abstract_ops[op_id];
+                int predecessor = state_index + op.get_hash_effect();
+                int alternative_cost = distance + op.get_cost();
+                if (alternative_cost < distances.get(predecessor)) {
+                    distances.set(predecessor, alternative_cost);
+                    pq.push(alternative_cost, predecessor);
+                    if (compute_plan) {
+                        generating_op_ids[predecessor] = op_id;
+                    }
                 }
-            }
-        }
+            });
     }
 }
 
 void PatternDatabaseFactory::compute_plan(
-    const MatchTree &match_tree,
+    const RegressionOperatorIndex &operator_index,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     bool compute_wildcard_plan) {
     /*
@@ -369,7 +636,8 @@ void PatternDatabaseFactory::compute_plan(
     initial_state.unpack();
     int current_state =
         projection.rank(initial_state.get_unpacked_values());
-    if (distances[current_state] != numeric_limits<int>::max()) {
+    if (distances.get(current_state) != numeric_limits<int>::max()) {
+        vector<int> successor_values;
         while (!is_goal_state(current_state)) {
             int op_id = generating_op_ids[current_state];
             assert(op_id != -1);
@@ -378,15 +646,16 @@ void PatternDatabaseFactory::compute_plan(
 
             // Compute equivalent ops
             vector<OperatorID> cheapest_operators;
-            vector<int> applicable_operator_ids;
-            match_tree.get_applicable_operator_ids(successor_state, applicable_operator_ids);
-            for (int applicable_op_id : applicable_operator_ids) {
-                const AbstractOperator &applicable_op = abstract_ops[applicable_op_id];
-                int predecessor = successor_state + applicable_op.get_hash_effect();
-                if (predecessor == current_state && op.get_cost() == applicable_op.get_cost()) {
-                    cheapest_operators.emplace_back(applicable_op.get_concrete_op_id());
-                }
-            }
+            unrank(successor_state, successor_values);
+            operator_index.for_each_applicable_operator(
+                successor_values,
+                [&](int applicable_op_id) {
+                    const AbstractOperator &applicable_op = abstract_ops[applicable_op_id];
+                    int predecessor = successor_state + applicable_op.get_hash_effect();
+                    if (predecessor == current_state && op.get_cost() == applicable_op.get_cost()) {
+                        cheapest_operators.emplace_back(applicable_op.get_concrete_op_id());
+                    }
+                });
             if (compute_wildcard_plan) {
                 rng->shuffle(cheapest_operators);
                 wildcard_plan.push_back(move(cheapest_operators));
@@ -402,6 +671,19 @@ void PatternDatabaseFactory::compute_plan(
     utils::release_vector_memory(generating_op_ids);
 }
 
+void PatternDatabaseFactory::compute_distances_and_plan(
+    bool compute_plan,
+    const shared_ptr<utils::RandomNumberGenerator> &rng,
+    bool compute_wildcard_plan) {
+    RegressionOperatorIndex operator_index(projection, abstract_ops);
+    compute_abstract_goals();
+    compute_distances(operator_index, compute_plan);
+
+    if (compute_plan) {
+        this->compute_plan(operator_index, rng, compute_wildcard_plan);
+    }
+}
+
 /*
   Note: if we move towards computing PDBs via command line option, e.g. as
   in pdb_heuristic(pdb(pattern=...)), then this class might become a builder
@@ -421,13 +703,23 @@ PatternDatabaseFactory::PatternDatabaseFactory(
            operator_costs.size() == task_proxy.get_operators().size());
     compute_variable_to_index(pattern);
     compute_abstract_operators(operator_costs);
-    unique_ptr<MatchTree> match_tree = compute_match_tree();
-    compute_abstract_goals();
-    compute_distances(*match_tree, compute_plan);
+    compute_distances_and_plan(compute_plan, rng, compute_wildcard_plan);
+}
 
-    if (compute_plan) {
-        this->compute_plan(*match_tree, rng, compute_wildcard_plan);
-    }
+PatternDatabaseFactory::PatternDatabaseFactory(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<const ProjectionOperators *> &base_projections,
+    const vector<vector<int>> &operators_by_variable,
+    const shared_ptr<utils::RandomNumberGenerator> &rng,
+    bool compute_wildcard_plan)
+    : task_proxy(task_proxy),
+      variables(task_proxy.get_variables()),
+      projection(task_proxy, pattern) {
+    compute_variable_to_index(pattern);
+    compute_abstract_operators_from_base_projections(
+        base_projections, operators_by_variable);
+    compute_distances_and_plan(true, rng, compute_wildcard_plan);
 }
 
 shared_ptr<PatternDatabase> compute_pdb(
@@ -435,8 +727,14 @@ shared_ptr<PatternDatabase> compute_pdb(
     const Pattern &pattern,
     const vector<int> &operator_costs,
     const shared_ptr<utils::RandomNumberGenerator> &rng) {
-    PatternDatabaseFactory pdb_factory(task_proxy, pattern, operator_costs, false, rng);
-    return pdb_factory.extract_pdb();
+    shared_ptr<PatternDatabase> pdb =
+        get_cached_pdb(task_proxy, pattern, operator_costs);
+    if (!pdb) {
+        PatternDatabaseFactory pdb_factory(task_proxy, pattern, operator_costs, false, rng);
+        pdb = pdb_factory.extract_pdb();
+        add_pdb_to_cache(task_proxy, operator_costs, pdb);
+    }
+    return pdb;
 }
 
 tuple<shared_ptr<PatternDatabase>, vector<vector<OperatorID>>>
@@ -446,9 +744,57 @@ compute_pdb_and_plan(
     const vector<int> &operator_costs,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     bool compute_wildcard_plan) {
+    /*
+      The plan depends on the generating operators found while computing
+      the distances and on the random number generator, so we cannot use
+      a cached PDB here. We still cache the result for compute_pdb().
+    */
     PatternDatabaseFactory pdb_factory(task_proxy, pattern, operator_costs, true, rng, compute_wildcard_plan);
+    shared_ptr<PatternDatabase> pdb = pdb_factory.extract_pdb();
+    add_pdb_to_cache(task_proxy, operator_costs, pdb);
+    return {
+               pdb, pdb_factory.extract_wildcard_plan()
+    };
+}
+
+IncrementalPDBFactory::IncrementalPDBFactory(const TaskProxy &task_proxy)
+    : task_proxy(task_proxy),
+      operators_by_variable(task_proxy.get_variables().size()) {
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int op_id = op.get_id();
+        for (FactProxy pre : op.get_preconditions()) {
+            operators_by_variable[pre.get_variable().get_id()].push_back(op_id);
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            vector<int> &var_ops =
+                operators_by_variable[eff.get_fact().get_variable().get_id()];
+            // Preconditions were added before, so duplicates are adjacent.
+            if (var_ops.empty() || var_ops.back() != op_id) {
+                var_ops.push_back(op_id);
+            }
+        }
+    }
+}
+
+tuple<shared_ptr<PatternDatabase>,
+      vector<vector<OperatorID>>,
+      unique_ptr<ProjectionOperators>>
+IncrementalPDBFactory::compute_pdb_and_plan(
+    const Pattern &pattern,
+    const vector<const ProjectionOperators *> &base_projections,
+    const shared_ptr<utils::RandomNumberGenerator> &rng,
+    bool compute_wildcard_plan) const {
+    PatternDatabaseFactory pdb_factory(
+        task_proxy, pattern, base_projections, operators_by_variable, rng,
+        compute_wildcard_plan);
+    shared_ptr<PatternDatabase> pdb = pdb_factory.extract_pdb();
+    add_pdb_to_cache(task_proxy, vector<int>(), pdb);
+    unique_ptr<ProjectionOperators> projection_operators =
+        utils::make_unique_ptr<ProjectionOperators>();
+    projection_operators->pattern = pattern;
+    projection_operators->operators = pdb_factory.extract_abstract_operators();
     return {
-               pdb_factory.extract_pdb(), pdb_factory.extract_wildcard_plan()
+               pdb, pdb_factory.extract_wildcard_plan(), move(projection_operators)
     };
 }
 }
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_FACTORY_H
 #define PDBS_PATTERN_DATABASE_FACTORY_H
 
+#include "abstract_operator.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -22,6 +23,9 @@ namespace pdbs {
   If operator_costs is given, it must contain one integer for each operator
   of the task, specifying the cost that should be considered for that operator
   instead of its original cost.
+
+  While the PDB cache is active (see pdb_cache.h), repeated calls for the
+  same task, pattern and operator costs return the same PDB object.
 */
 extern std::shared_ptr<PatternDatabase> compute_pdb(
     const TaskProxy &task_proxy,
@@ -50,6 +54,55 @@ extern std::tuple<std::shared_ptr<PatternDatabase>,
     const std::vector<int> &operator_costs = std::vector<int>(),
     const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
     bool compute_wildcard_plan = false);
+
+/*
+  The abstract operators of the projection onto a pattern, grouped by
+  concrete operator in increasing order of concrete operator IDs.
+*/
+struct ProjectionOperators {
+    Pattern pattern;
+    std::vector<AbstractOperator> operators;
+};
+
+/*
+  Compute PDBs and plans like compute_pdb_and_plan() (for the original
+  operator costs) for patterns that are built by merging previously
+  computed patterns and adding variables to them, as done by the CEGAR
+  pattern collection generators.
+
+  The given base projections must have disjoint patterns that are subsets
+  of the new pattern. The abstract operators of a concrete operator that
+  only mentions variables of a single base pattern (among the variables
+  of the new pattern) are derived from the abstract operators of that
+  base projection instead of being rebuilt from the concrete operator,
+  and concrete operators that mention no variable of the new pattern are
+  skipped. The result is the same as for compute_pdb_and_plan().
+
+  We do not use the PDBs of the base projections as lower bounds for the
+  refined PDB: the refined PDB needs the exact distances of all abstract
+  states, so a backward Dijkstra search has to settle every abstract state
+  anyway.
+*/
+class IncrementalPDBFactory {
+    TaskProxy task_proxy;
+    // IDs of the operators that mention a variable in a precondition or effect.
+    std::vector<std::vector<int>> operators_by_variable;
+public:
+    explicit IncrementalPDBFactory(const TaskProxy &task_proxy);
+
+    /*
+      Return the PDB and the plan for the given pattern and the abstract
+      operators of the projection onto the pattern, which can serve as a
+      base projection for later calls.
+    */
+    std::tuple<std::shared_ptr<PatternDatabase>,
+               std::vector<std::vector<OperatorID>>,
+               std::unique_ptr<ProjectionOperators>> compute_pdb_and_plan(
+        const Pattern &pattern,
+        const std::vector<const ProjectionOperators *> &base_projections,
+        const std::shared_ptr<utils::RandomNumberGenerator> &rng,
+        bool compute_wildcard_plan) const;
+};
 }
 
 #endif
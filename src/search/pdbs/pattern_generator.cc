@@ -1,5 +1,6 @@
 #include "pattern_generator.h"
 
+#include "pdb_cache.h"
 #include "utils.h"
 
 #include "../plugins/plugin.h"
@@ -7,8 +8,13 @@
 using namespace std;
 
 namespace pdbs {
+static int64_t get_pdb_cache_memory_in_bytes(const plugins::Options &opts) {
+    return static_cast<int64_t>(opts.get<int>("pdb_cache_memory")) * 1024 * 1024;
+}
+
 PatternCollectionGenerator::PatternCollectionGenerator(const plugins::Options &opts)
-    : log(utils::get_log_from_options(opts)) {
+    : pdb_cache_memory_in_bytes(get_pdb_cache_memory_in_bytes(opts)),
+      log(utils::get_log_from_options(opts)) {
 }
 
 PatternCollectionInformation PatternCollectionGenerator::generate(
@@ -16,6 +22,8 @@ PatternCollectionInformation PatternCollectionGenerator::generate(
     if (log.is_at_least_normal()) {
         log << "Generating patterns using: " << name() << endl;
     }
+    // Cached PDBs are released when pattern generation ends.
+    PDBCacheScope pdb_cache_scope(pdb_cache_memory_in_bytes);
     utils::Timer timer;
     PatternCollectionInformation pci = compute_patterns(task);
     dump_pattern_collection_generation_statistics(
@@ -24,7 +32,8 @@ PatternCollectionInformation PatternCollectionGenerator::generate(
 }
 
 PatternGenerator::PatternGenerator(const plugins::Options &opts)
-    : log(utils::get_log_from_options(opts)) {
+    : pdb_cache_memory_in_bytes(get_pdb_cache_memory_in_bytes(opts)),
+      log(utils::get_log_from_options(opts)) {
 }
 
 PatternInformation PatternGenerator::generate(
@@ -32,6 +41,7 @@ PatternInformation PatternGenerator::generate(
     if (log.is_at_least_normal()) {
         log << "Generating pattern using: " << name() << endl;
     }
+    PDBCacheScope pdb_cache_scope(pdb_cache_memory_in_bytes);
     utils::Timer timer;
     PatternInformation pattern_info = compute_pattern(task);
     dump_pattern_generation_statistics(
@@ -43,6 +53,14 @@ PatternInformation PatternGenerator::generate(
 }
 
 void add_generator_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "pdb_cache_memory",
+        "memory budget in MiB for caching PDBs while generating patterns, "
+        "so that PDBs computed repeatedly for the same pattern and operator "
+        "costs are only built once. The cache is cleared when pattern "
+        "generation ends. Use 0 to disable the cache.",
+        "0",
+        plugins::Bounds("0", "infinity"));
     utils::add_log_options_to_feature(feature);
 }
 
@@ -7,6 +7,7 @@
 
 #include "../utils/logging.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -26,6 +27,8 @@ class PatternCollectionGenerator {
     virtual std::string name() const = 0;
     virtual PatternCollectionInformation compute_patterns(
         const std::shared_ptr<AbstractTask> &task) = 0;
+    // Memory budget for the PDB cache (see pdb_cache.h).
+    int64_t pdb_cache_memory_in_bytes;
 protected:
     mutable utils::LogProxy log;
 public:
@@ -40,6 +43,7 @@ class PatternGenerator {
     virtual std::string name() const = 0;
     virtual PatternInformation compute_pattern(
         const std::shared_ptr<AbstractTask> &task) = 0;
+    int64_t pdb_cache_memory_in_bytes;
 protected:
     mutable utils::LogProxy log;
 public:
@@ -41,6 +41,10 @@ public:
         return task_proxy;
     }
 
+    bool has_pdb() const {
+        return pdb != nullptr;
+    }
+
     const Pattern &get_pattern() const;
     std::shared_ptr<PatternDatabase> get_pdb();
 };
@@ -0,0 +1,166 @@
+#include "pdb_cache.h"
+
+#include "pattern_database.h"
+
+#include "../task_id.h"
+#include "../task_proxy.h"
+
+#include "../algorithms/subscriber.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/hash.h"
+#include "../utils/memory.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <list>
+#include <mutex>
+
+using namespace std;
+
+namespace pdbs {
+class PDBCache : public subscriber::Subscriber<AbstractTask> {
+    using Key = pair<TaskID, pair<Pattern, vector<int>>>;
+
+    struct Entry {
+        Key key;
+        shared_ptr<PatternDatabase> pdb;
+        int64_t size_in_bytes;
+    };
+
+    // Ordered from the most recently to the least recently used entry.
+    list<Entry> entries;
+    utils::HashMap<Key, list<Entry>::iterator> entry_by_key;
+    utils::HashSet<TaskID> subscribed_tasks;
+    int64_t size_in_bytes;
+    /*
+      Memory budget for the PDBs held by the cache. PDBs that are also
+      used elsewhere (e.g., by a heuristic) are counted as well, even
+      though evicting them does not free their memory.
+    */
+    const int64_t memory_budget_in_bytes;
+    mutex cache_mutex;
+
+    static Key get_key(
+        const TaskProxy &task_proxy, const Pattern &pattern,
+        const vector<int> &operator_costs) {
+        return Key(
+            task_proxy.get_id(),
+            make_pair(pattern,
+                      operator_costs.empty()
+                      ? task_properties::get_operator_costs(task_proxy)
+                      : operator_costs));
+    }
+
+    void remove_entry(list<Entry>::iterator it) {
+        size_in_bytes -= it->size_in_bytes;
+        entry_by_key.erase(it->key);
+        entries.erase(it);
+    }
+
+    virtual void notify_service_destroyed(const AbstractTask *task) override {
+        lock_guard<mutex> lock(cache_mutex);
+        TaskID task_id(task);
+        subscribed_tasks.erase(task_id);
+        for (auto it = entries.begin(); it != entries.end();) {
+            auto next = it;
+            ++next;
+            if (it->key.first == task_id) {
+                remove_entry(it);
+            }
+            it = next;
+        }
+    }
+public:
+    explicit PDBCache(int64_t memory_budget_in_bytes)
+        : size_in_bytes(0),
+          memory_budget_in_bytes(memory_budget_in_bytes) {
+    }
+
+    shared_ptr<PatternDatabase> lookup(
+        const TaskProxy &task_proxy, const Pattern &pattern,
+        const vector<int> &operator_costs) {
+        Key key = get_key(task_proxy, pattern, operator_costs);
+        lock_guard<mutex> lock(cache_mutex);
+        auto it = entry_by_key.find(key);
+        if (it == entry_by_key.end()) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->pdb;
+    }
+
+    void insert(
+        const TaskProxy &task_proxy, const vector<int> &operator_costs,
+        const shared_ptr<PatternDatabase> &pdb) {
+        if (pdb->get_size_in_bytes() > memory_budget_in_bytes) {
+            return;
+        }
+        Key key = get_key(task_proxy, pdb->get_pattern(), operator_costs);
+        int64_t entry_size = pdb->get_size_in_bytes() +
+            (key.second.first.size() + key.second.second.size()) * sizeof(int);
+        lock_guard<mutex> lock(cache_mutex);
+        if (entry_size > memory_budget_in_bytes) {
+            return;
+        }
+        auto it = entry_by_key.find(key);
+        if (it != entry_by_key.end()) {
+            // Another thread computed the same PDB concurrently.
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+        while (size_in_bytes + entry_size > memory_budget_in_bytes) {
+            remove_entry(prev(entries.end()));
+        }
+        if (subscribed_tasks.insert(key.first).second) {
+            task_proxy.subscribe_to_task_destruction(this);
+        }
+        entries.push_front({key, pdb, entry_size});
+        entry_by_key.emplace(move(key), entries.begin());
+        size_in_bytes += entry_size;
+    }
+};
+
+// The cache of the outermost PDBCacheScope, or nullptr if there is none.
+static atomic<PDBCache *> active_cache(nullptr);
+
+PDBCacheScope::PDBCacheScope(int64_t memory_budget_in_bytes) {
+    unique_ptr<PDBCache> new_cache =
+        utils::make_unique_ptr<PDBCache>(memory_budget_in_bytes);
+    PDBCache *expected = nullptr;
+    if (active_cache.compare_exchange_strong(expected, new_cache.get())) {
+        cache = move(new_cache);
+    }
+}
+
+/*
+  Destroying the cache releases the cached PDBs and unsubscribes it from
+  the tasks that are still alive.
+*/
+PDBCacheScope::~PDBCacheScope() {
+    if (cache) {
+        active_cache.store(nullptr);
+    }
+}
+
+shared_ptr<PatternDatabase> get_cached_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    PDBCache *cache = active_cache.load();
+    if (!cache) {
+        return nullptr;
+    }
+    return cache->lookup(task_proxy, pattern, operator_costs);
+}
+
+void add_pdb_to_cache(
+    const TaskProxy &task_proxy,
+    const vector<int> &operator_costs,
+    const shared_ptr<PatternDatabase> &pdb) {
+    PDBCache *cache = active_cache.load();
+    if (cache) {
+        cache->insert(task_proxy, operator_costs, pdb);
+    }
+}
+}
@@ -0,0 +1,60 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "types.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class TaskProxy;
+
+namespace pdbs {
+class PDBCache;
+
+/*
+  Cache of pattern databases, used by compute_pdb() to avoid rebuilding
+  PDBs that have already been computed for the same task, pattern and
+  operator costs during pattern generation (e.g., by the pattern CEGAR
+  or for candidate patterns of the hill-climbing search).
+
+  The cache is disabled by default. It is only active while a
+  PDBCacheScope with a positive memory budget exists. Entries are
+  evicted in least-recently-used order when the PDBs held by the cache
+  exceed this budget, and all entries are removed when the scope ends,
+  so discarded candidate PDBs do not stay alive during the search. The
+  cache is owned by the outermost scope and can be used from multiple
+  threads, as long as the scope outlives them.
+
+  Entries are keyed by the task, the pattern and the operator costs. Empty
+  operator costs stand for the costs of the task, so PDBs computed with
+  and without explicit costs are looked up under the same key.
+*/
+class PDBCacheScope {
+    // Only set for the outermost scope.
+    std::unique_ptr<PDBCache> cache;
+public:
+    /*
+      Enable the cache with the given budget. If a scope is already
+      active (e.g., for a pattern generator called by another one), the
+      budget of the outer scope is kept.
+    */
+    explicit PDBCacheScope(int64_t memory_budget_in_bytes);
+    ~PDBCacheScope();
+
+    PDBCacheScope(const PDBCacheScope &) = delete;
+    PDBCacheScope &operator=(const PDBCacheScope &) = delete;
+};
+
+extern std::shared_ptr<PatternDatabase> get_cached_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const std::vector<int> &operator_costs);
+
+extern void add_pdb_to_cache(
+    const TaskProxy &task_proxy,
+    const std::vector<int> &operator_costs,
+    const std::shared_ptr<PatternDatabase> &pdb);
+}
+
+#endif
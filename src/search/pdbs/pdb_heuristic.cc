@@ -2,6 +2,8 @@
 
 #include "pattern_database.h"
 #include "pattern_generator.h"
+#include "symbolic_pdb_factory.h"
+#include "utils.h"
 
 #include "../plugins/plugin.h"
 
@@ -12,16 +14,29 @@ using namespace std;
 
 namespace pdbs {
 shared_ptr<PatternDatabase> get_pdb_from_options(const shared_ptr<AbstractTask> &task,
-                                                 const plugins::Options &opts) {
+                                                 const plugins::Options &opts,
+                                                 utils::LogProxy &log) {
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     PatternInformation pattern_info = pattern_generator->generate(task);
-    return pattern_info.get_pdb();
+    if (opts.get<PDBRepresentation>("representation") == PDBRepresentation::SYMBOLIC) {
+        if (!pattern_info.has_pdb()) {
+            return compute_symbolic_pdb(TaskProxy(*task), pattern_info.get_pattern());
+        } else if (log.is_warning()) {
+            log << "Warning: the pattern generator already computed an "
+                << "explicit PDB, ignoring representation=symbolic" << endl;
+        }
+    }
+    shared_ptr<PatternDatabase> pdb = pattern_info.get_pdb();
+    if (!opts.get<bool>("compress_distances")) {
+        pdb->uncompress_distances();
+    }
+    return pdb;
 }
 
 PDBHeuristic::PDBHeuristic(const plugins::Options &opts)
     : Heuristic(opts),
-      pdb(get_pdb_from_options(task, opts)) {
+      pdb(get_pdb_from_options(task, opts, log)) {
 }
 
 int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -43,6 +58,8 @@ public:
             "pattern",
             "pattern generation method",
             "greedy()");
+        add_pdb_representation_option_to_feature(*this);
+        add_distance_compression_option_to_feature(*this);
         Heuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
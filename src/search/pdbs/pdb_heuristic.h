@@ -23,6 +23,10 @@ public:
     */
     PDBHeuristic(const plugins::Options &opts);
     virtual ~PDBHeuristic() override = default;
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
@@ -0,0 +1,85 @@
+#include "regression_operator_index.h"
+
+#include "pattern_database.h"
+
+#include <cassert>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+namespace pdbs {
+RegressionOperatorIndex::RegressionOperatorIndex(
+    const Projection &projection, const vector<AbstractOperator> &operators) {
+    map<vector<int>, int> group_ids;
+    vector<vector<pair<int, int>>> ranked_operators_by_group;
+    vector<int> num_ranks_by_group;
+    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
+        const vector<FactPair> &preconditions =
+            operators[op_id].get_regression_preconditions();
+        vector<int> variables;
+        variables.reserve(preconditions.size());
+        for (const FactPair &pre : preconditions) {
+            variables.push_back(pre.var);
+        }
+
+        auto result = group_ids.emplace(variables, groups.size());
+        int group_id = result.first->second;
+        if (result.second) {
+            Group group;
+            group.dense = false;
+            int num_ranks = 1;
+            for (int var : variables) {
+                group.strides.push_back(num_ranks);
+                num_ranks *= projection.get_domain_size(var);
+            }
+            group.variables = move(variables);
+            groups.push_back(move(group));
+            ranked_operators_by_group.emplace_back();
+            num_ranks_by_group.push_back(num_ranks);
+        }
+
+        const Group &group = groups[group_id];
+        int rank = 0;
+        for (size_t i = 0; i < preconditions.size(); ++i) {
+            assert(preconditions[i].var == group.variables[i]);
+            rank += group.strides[i] * preconditions[i].value;
+        }
+        ranked_operators_by_group[group_id].emplace_back(rank, op_id);
+    }
+
+    for (size_t group_id = 0; group_id < groups.size(); ++group_id) {
+        Group &group = groups[group_id];
+        vector<pair<int, int>> &ranked_operators =
+            ranked_operators_by_group[group_id];
+        // Operators with the same rank remain sorted by ID.
+        stable_sort(ranked_operators.begin(), ranked_operators.end(),
+                    [](const pair<int, int> &lhs, const pair<int, int> &rhs) {
+                        return lhs.first < rhs.first;
+                    });
+        int num_operators = ranked_operators.size();
+        int num_ranks = num_ranks_by_group[group_id];
+        group.dense = num_ranks <= 2 * num_operators + 64;
+        group.operator_ids.reserve(num_operators);
+        if (group.dense) {
+            group.offsets.assign(num_ranks + 1, 0);
+        } else {
+            group.ranks.reserve(num_operators);
+        }
+        for (const pair<int, int> &ranked_operator : ranked_operators) {
+            if (group.dense) {
+                ++group.offsets[ranked_operator.first + 1];
+            } else {
+                group.ranks.push_back(ranked_operator.first);
+            }
+            group.operator_ids.push_back(ranked_operator.second);
+        }
+        if (group.dense) {
+            for (int rank = 0; rank < num_ranks; ++rank) {
+                group.offsets[rank + 1] += group.offsets[rank];
+            }
+            assert(group.offsets.back() == num_operators);
+        }
+    }
+}
+}
@@ -0,0 +1,90 @@
+#ifndef PDBS_REGRESSION_OPERATOR_INDEX_H
+#define PDBS_REGRESSION_OPERATOR_INDEX_H
+
+#include "abstract_operator.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace pdbs {
+class Projection;
+
+/*
+  Index of abstract operators by their regression preconditions, used to
+  find the operators that are applicable (in regression) to an abstract
+  state.
+
+  Operators are partitioned into groups by the set of pattern variables
+  mentioned in their regression preconditions. Within a group, an
+  operator is applicable in a state iff the projection of the state to
+  these variables equals the precondition. We rank these projections
+  with the same mixed-radix scheme (using per-group strides) as the
+  abstract states themselves, so all operators of a group that are
+  applicable in a state are stored contiguously and can be found with a
+  single lookup: a dense offset table if the ranked space of the group is
+  small and a sorted array (searched by binary search) otherwise.
+
+  Compared to a match tree, lookups need no recursion and no allocation,
+  and the number of groups is typically small.
+*/
+class RegressionOperatorIndex {
+    struct Group {
+        // Pattern variables (indices into the pattern) and their strides.
+        std::vector<int> variables;
+        std::vector<int> strides;
+        bool dense;
+        /*
+          For dense groups, offsets[r] is the position in operator_ids of
+          the first operator whose precondition has rank r. For sparse
+          groups, ranks[i] is the rank of the precondition of
+          operator_ids[i], in increasing order.
+        */
+        std::vector<int> offsets;
+        std::vector<int> ranks;
+        std::vector<int> operator_ids;
+
+        int rank(const std::vector<int> &state_values) const {
+            int result = 0;
+            for (size_t i = 0; i < variables.size(); ++i) {
+                result += strides[i] * state_values[variables[i]];
+            }
+            return result;
+        }
+    };
+
+    std::vector<Group> groups;
+public:
+    RegressionOperatorIndex(
+        const Projection &projection,
+        const std::vector<AbstractOperator> &operators);
+
+    /*
+      Call callback(op_id) for the ID of every operator that is applicable
+      in regression to the abstract state with the given values (one value
+      per pattern variable).
+    */
+    template<typename Callback>
+    void for_each_applicable_operator(
+        const std::vector<int> &state_values, const Callback &callback) const {
+        for (const Group &group : groups) {
+            int rank = group.rank(state_values);
+            int begin;
+            int end;
+            if (group.dense) {
+                begin = group.offsets[rank];
+                end = group.offsets[rank + 1];
+            } else {
+                auto range = std::equal_range(
+                    group.ranks.begin(), group.ranks.end(), rank);
+                begin = range.first - group.ranks.begin();
+                end = range.second - group.ranks.begin();
+            }
+            for (int i = begin; i < end; ++i) {
+                callback(group.operator_ids[i]);
+            }
+        }
+    }
+};
+}
+
+#endif
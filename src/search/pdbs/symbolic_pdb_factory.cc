@@ -0,0 +1,246 @@
+#include "symbolic_pdb_factory.h"
+
+#include "decision_diagram.h"
+#include "pattern_database.h"
+
+#include "../task_proxy.h"
+
+#include "../plugins/plugin.h"
+#include "../utils/hash.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+
+using namespace std;
+
+namespace pdbs {
+using Operation = DecisionDiagramManager::Operation;
+
+struct SymbolicOperator {
+    // Set of states that satisfy the preconditions.
+    int precondition;
+    // Effects as pairs of levels and values.
+    vector<pair<int, int>> effects;
+};
+
+class SymbolicPDBFactory {
+    const TaskProxy &task_proxy;
+    Projection projection;
+    DecisionDiagramManager manager;
+    vector<int> variable_to_level;
+    // Operators with effects on the pattern, grouped by cost.
+    map<int, vector<SymbolicOperator>> operators_by_cost;
+
+    static vector<int> get_domain_sizes(const Projection &projection);
+    void compute_operators(const vector<int> &operator_costs);
+    int compute_goal_states();
+
+    // Return the set of states from which op reaches a state in states.
+    int compute_preimage(int states, const SymbolicOperator &op);
+    int compute_preimage(int states, const vector<SymbolicOperator> &ops);
+
+    /*
+      Compute the goal distances with a uniform-cost search on sets of
+      states: bucket d contains all states that have been reached with
+      cost d. Buckets are expanded in order of increasing cost. Return
+      the layers of states with equal distance as pairs of distances and
+      sets of states.
+    */
+    vector<pair<int, int>> compute_distance_layers();
+public:
+    SymbolicPDBFactory(
+        const TaskProxy &task_proxy, const Pattern &pattern,
+        const vector<int> &operator_costs);
+
+    shared_ptr<PatternDatabase> compute_pdb();
+};
+
+SymbolicPDBFactory::SymbolicPDBFactory(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs)
+    : task_proxy(task_proxy),
+      projection(task_proxy, pattern),
+      manager(get_domain_sizes(projection)),
+      variable_to_level(task_proxy.get_variables().size(), -1) {
+    assert(operator_costs.empty() ||
+           operator_costs.size() == task_proxy.get_operators().size());
+    for (size_t level = 0; level < pattern.size(); ++level) {
+        variable_to_level[pattern[level]] = level;
+    }
+    compute_operators(operator_costs);
+}
+
+vector<int> SymbolicPDBFactory::get_domain_sizes(const Projection &projection) {
+    vector<int> domain_sizes;
+    for (size_t level = 0; level < projection.get_pattern().size(); ++level) {
+        domain_sizes.push_back(projection.get_domain_size(level));
+    }
+    return domain_sizes;
+}
+
+void SymbolicPDBFactory::compute_operators(const vector<int> &operator_costs) {
+    /*
+      Different operators often have the same projection, so we only keep
+      one operator for each combination of cost, preconditions and effects.
+    */
+    utils::HashSet<vector<int>> projected_operators;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        vector<pair<int, int>> preconditions;
+        for (FactProxy pre : op.get_preconditions()) {
+            int level = variable_to_level[pre.get_variable().get_id()];
+            if (level != -1) {
+                preconditions.emplace_back(level, pre.get_value());
+            }
+        }
+        vector<pair<int, int>> effects;
+        for (EffectProxy eff : op.get_effects()) {
+            FactProxy fact = eff.get_fact();
+            int level = variable_to_level[fact.get_variable().get_id()];
+            if (level != -1) {
+                effects.emplace_back(level, fact.get_value());
+            }
+        }
+        if (effects.empty()) {
+            continue;
+        }
+        sort(preconditions.begin(), preconditions.end());
+        sort(effects.begin(), effects.end());
+
+        int cost = operator_costs.empty() ? op.get_cost() : operator_costs[op.get_id()];
+        vector<int> key = {cost, static_cast<int>(preconditions.size())};
+        for (const pair<int, int> &fact : preconditions) {
+            key.push_back(fact.first);
+            key.push_back(fact.second);
+        }
+        for (const pair<int, int> &fact : effects) {
+            key.push_back(fact.first);
+            key.push_back(fact.second);
+        }
+        if (projected_operators.insert(move(key)).second) {
+            operators_by_cost[cost].push_back(
+                {manager.make_cube(preconditions), move(effects)});
+        }
+    }
+}
+
+int SymbolicPDBFactory::compute_goal_states() {
+    vector<pair<int, int>> goals;
+    for (FactProxy goal : task_proxy.get_goals()) {
+        int level = variable_to_level[goal.get_variable().get_id()];
+        if (level != -1) {
+            goals.emplace_back(level, goal.get_value());
+        }
+    }
+    return manager.make_cube(goals);
+}
+
+int SymbolicPDBFactory::compute_preimage(int states, const SymbolicOperator &op) {
+    int successors = states;
+    for (const pair<int, int> &effect : op.effects) {
+        successors = manager.restrict(successors, effect.first, effect.second);
+    }
+    return manager.apply(Operation::AND, successors, op.precondition);
+}
+
+int SymbolicPDBFactory::compute_preimage(
+    int states, const vector<SymbolicOperator> &ops) {
+    int preimage = manager.get_terminal(0);
+    for (const SymbolicOperator &op : ops) {
+        preimage = manager.apply(
+            Operation::OR, preimage, compute_preimage(states, op));
+    }
+    return preimage;
+}
+
+vector<pair<int, int>> SymbolicPDBFactory::compute_distance_layers() {
+    const int empty_set = manager.get_terminal(0);
+    vector<pair<int, int>> layers;
+    int reached = empty_set;
+    map<int, int> buckets;
+    buckets[0] = compute_goal_states();
+    while (!buckets.empty()) {
+        int distance = buckets.begin()->first;
+        int layer = manager.apply(
+            Operation::AND_NOT, buckets.begin()->second, reached);
+        buckets.erase(buckets.begin());
+
+        // Close the layer under operators with cost 0.
+        auto zero_cost_ops = operators_by_cost.find(0);
+        if (zero_cost_ops != operators_by_cost.end()) {
+            int new_states = layer;
+            while (new_states != empty_set) {
+                int predecessors = compute_preimage(new_states, zero_cost_ops->second);
+                predecessors = manager.apply(Operation::AND_NOT, predecessors, reached);
+                new_states = manager.apply(Operation::AND_NOT, predecessors, layer);
+                layer = manager.apply(Operation::OR, layer, new_states);
+            }
+        }
+        if (layer == empty_set) {
+            continue;
+        }
+        reached = manager.apply(Operation::OR, reached, layer);
+        layers.emplace_back(distance, layer);
+
+        for (const auto &[cost, ops] : operators_by_cost) {
+            if (cost == 0) {
+                continue;
+            }
+            int predecessors = manager.apply(
+                Operation::AND_NOT, compute_preimage(layer, ops), reached);
+            if (predecessors != empty_set) {
+                auto it = buckets.find(distance + cost);
+                if (it == buckets.end()) {
+                    buckets[distance + cost] = predecessors;
+                } else {
+                    it->second = manager.apply(Operation::OR, it->second, predecessors);
+                }
+            }
+        }
+    }
+    return layers;
+}
+
+shared_ptr<PatternDatabase> SymbolicPDBFactory::compute_pdb() {
+    int distances = manager.get_terminal(numeric_limits<int>::max());
+    for (const pair<int, int> &layer : compute_distance_layers()) {
+        int layer_distances = manager.apply(
+            Operation::MASK, layer.second, manager.get_terminal(layer.first));
+        distances = manager.apply(Operation::MIN, distances, layer_distances);
+    }
+    unique_ptr<DistanceDiagram> distance_diagram =
+        utils::make_unique_ptr<DistanceDiagram>(
+            manager, distances, projection.get_pattern());
+    return make_shared<PatternDatabase>(
+        move(projection), move(distance_diagram));
+}
+
+shared_ptr<PatternDatabase> compute_symbolic_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    SymbolicPDBFactory factory(task_proxy, pattern, operator_costs);
+    return factory.compute_pdb();
+}
+
+void add_pdb_representation_option_to_feature(plugins::Feature &feature) {
+    feature.add_option<PDBRepresentation>(
+        "representation",
+        "representation of the goal distances of the PDBs. Symbolic PDBs "
+        "are computed from the patterns of the pattern generator, so use "
+        "them with generators that only compute patterns, such as "
+        "manual_pattern, greedy, manual_patterns or systematic. If the "
+        "generator already computed explicit PDBs (e.g., cegar_pattern or "
+        "hillclimbing), these are used and the option is ignored.",
+        "explicit");
+}
+
+static plugins::TypedEnumPlugin<PDBRepresentation> _enum_plugin({
+        {"explicit", "store one distance per abstract state in a table"},
+        {"symbolic", "compute the distances with a symbolic backward search "
+         "and store them in a decision diagram, which can be much smaller "
+         "than a table for large patterns"}
+    });
+}
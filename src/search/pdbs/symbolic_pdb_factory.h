@@ -0,0 +1,42 @@
+#ifndef PDBS_SYMBOLIC_PDB_FACTORY_H
+#define PDBS_SYMBOLIC_PDB_FACTORY_H
+
+#include "types.h"
+
+#include <memory>
+#include <vector>
+
+class TaskProxy;
+
+namespace plugins {
+class Feature;
+}
+
+namespace pdbs {
+enum class PDBRepresentation {
+    EXPLICIT,
+    SYMBOLIC
+};
+
+/*
+  Compute a PDB for the given task and pattern whose distances are
+  represented by a decision diagram instead of an explicit table (see
+  DistanceDiagram). The distances are computed with a symbolic backward
+  search from the abstract goal states, which handles sets of abstract
+  states as decision diagrams and never enumerates the abstract states.
+  The requirements on pattern and operator_costs are the same as for
+  compute_pdb().
+
+  Symbolic PDBs pay off for large patterns whose distance functions have
+  compact diagrams. For small patterns, explicit PDBs are usually faster
+  to build and to evaluate.
+*/
+extern std::shared_ptr<PatternDatabase> compute_symbolic_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const std::vector<int> &operator_costs = std::vector<int>());
+
+extern void add_pdb_representation_option_to_feature(plugins::Feature &feature);
+}
+
+#endif
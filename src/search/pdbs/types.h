@@ -6,6 +6,7 @@
 
 namespace pdbs {
 class PatternDatabase;
+enum class DistanceStorage;
 using Pattern = std::vector<int>;
 using PatternCollection = std::vector<Pattern>;
 using PDBCollection = std::vector<std::shared_ptr<PatternDatabase>>;
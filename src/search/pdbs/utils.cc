@@ -6,6 +6,7 @@
 
 #include "../task_proxy.h"
 
+#include "../plugins/plugin.h"
 #include "../task_utils/causal_graph.h"
 #include "../task_utils/task_properties.h"
 
@@ -154,4 +155,15 @@ string get_rovner_et_al_reference() {
         "AAAI Press",
         "2019");
 }
+
+void add_distance_compression_option_to_feature(plugins::Feature &feature) {
+    feature.add_option<bool>(
+        "compress_distances",
+        "store the distances of explicit PDBs with as few bits per abstract "
+        "state as the largest finite distance allows. Without compression, "
+        "every distance uses 32 bits, which makes lookups faster but can "
+        "need up to 16 times as much memory. Symbolic PDBs are not affected. "
+        "PDBs are always compressed during pattern generation.",
+        "true");
+}
 }
@@ -10,6 +10,10 @@
 #include <memory>
 #include <string>
 
+namespace plugins {
+class Feature;
+}
+
 namespace utils {
 class LogProxy;
 class RandomNumberGenerator;
@@ -66,6 +70,12 @@ extern void dump_pattern_collection_generation_statistics(
     utils::LogProxy &log);
 
 extern std::string get_rovner_et_al_reference();
+
+/*
+  Add the option compress_distances. If it is false, heuristics call
+  PatternDatabase::uncompress_distances() for their final PDBs.
+*/
+extern void add_distance_compression_option_to_feature(plugins::Feature &feature);
 }
 
 #endif
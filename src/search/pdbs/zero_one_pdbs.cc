@@ -57,6 +57,12 @@ int ZeroOnePDBs::get_value(const State &state) const {
     return h_val;
 }
 
+void ZeroOnePDBs::uncompress_distances() {
+    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
+        pdb->uncompress_distances();
+    }
+}
+
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     double approx_mean_finite_h = 0;
     for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
@@ -18,6 +18,8 @@ public:
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
+    // See PatternDatabase::uncompress_distances().
+    void uncompress_distances();
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
@@ -1,6 +1,7 @@
 #include "zero_one_pdbs_heuristic.h"
 
 #include "pattern_generator.h"
+#include "utils.h"
 
 #include "../plugins/plugin.h"
 
@@ -18,7 +19,11 @@ ZeroOnePDBs get_zero_one_pdbs_from_options(
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    ZeroOnePDBs zero_one_pdbs(task_proxy, *patterns);
+    if (!opts.get<bool>("compress_distances")) {
+        zero_one_pdbs.uncompress_distances();
+    }
+    return zero_one_pdbs;
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
@@ -55,6 +60,7 @@ public:
             "patterns",
             "pattern generation method",
             "systematic(1)");
+        add_distance_compression_option_to_feature(*this);
         Heuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
@@ -40,6 +40,15 @@ public:
     bool test(int index) const;
     void intersect(const BitsetView &other);
     int size() const;
+
+    int get_num_blocks() const {
+        return data.size();
+    }
+
+    // Bits beyond size() are always unset.
+    BitsetMath::Block get_block(int block_index) const {
+        return data[block_index];
+    }
 };
 
 
@@ -51,6 +51,7 @@ SearchEngine::SearchEngine(const plugins::Options &opts)
       successor_generator(get_successor_generator(task_proxy, log)),
       search_space(state_registry, log),
       statistics(log),
+      profiler(opts, log, state_registry, statistics),
       cost_type(opts.get<OperatorCost>("cost_type")),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
       max_time(opts.get<double>("max_time")) {
@@ -59,6 +60,10 @@ SearchEngine::SearchEngine(const plugins::Options &opts)
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
     bound = opts.get<int>("bound");
+    if (profiler.is_enabled()) {
+        statistics.set_profiler(&profiler);
+        state_registry.enable_hash_set_statistics();
+    }
     task_properties::print_variable_statistics(task_proxy);
 }
 
@@ -96,6 +101,7 @@ void SearchEngine::search() {
     }
     // TODO: Revise when and which search times are logged.
     log << "Actual search time: " << timer.get_elapsed_time() << endl;
+    profiler.report_final_profile();
 }
 
 bool SearchEngine::check_goal_and_set_plan(const State &state) {
@@ -148,6 +154,7 @@ void SearchEngine::add_options_to_feature(plugins::Feature &feature) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    add_profiler_options_to_feature(feature);
     utils::add_log_options_to_feature(feature);
 }
 
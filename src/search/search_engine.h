@@ -4,6 +4,7 @@
 #include "operator_cost.h"
 #include "operator_id.h"
 #include "plan_manager.h"
+#include "search_profiler.h"
 #include "search_progress.h"
 #include "search_space.h"
 #include "search_statistics.h"
@@ -48,6 +49,7 @@ protected:
     SearchSpace search_space;
     SearchProgress search_progress;
     SearchStatistics statistics;
+    SearchProfiler profiler;
     int bound;
     OperatorCost cost_type;
     bool is_unit_cost;
@@ -59,6 +61,10 @@ protected:
     void set_plan(const Plan &plan);
     bool check_goal_and_set_plan(const State &state);
     int get_adjusted_cost(const OperatorProxy &op) const;
+    // Return nullptr if profiling is disabled (see ProfilingScope).
+    SearchProfiler *get_profiler() const {
+        return statistics.get_profiler();
+    }
 public:
     SearchEngine(const plugins::Options &opts);
     virtual ~SearchEngine();
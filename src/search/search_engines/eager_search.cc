@@ -2,14 +2,16 @@
 
 #include "../evaluation_context.h"
 #include "../evaluator.h"
+#include "../heuristic.h"
 #include "../open_list_factory.h"
 #include "../pruning_method.h"
 
 #include "../algorithms/ordered_set.h"
-#include "../plugins/options.h"
+#include "../plugins/plugin.h"
 #include "../task_utils/successor_generator.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <memory>
@@ -27,7 +29,8 @@ EagerSearch::EagerSearch(const plugins::Options &opts)
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      thread_pool(opts.get<int>("num_threads")) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -40,6 +43,16 @@ void EagerSearch::initialize() {
         << " reopening closed nodes, (real) bound = " << bound
         << endl;
     assert(open_list);
+    if (thread_pool.get_num_threads() > 1) {
+        if (!open_list->supports_concurrent_evaluation()) {
+            cerr << "num_threads > 1 requires that all evaluators of the "
+                 << "open list support concurrent evaluation" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        Heuristic::enable_concurrent_evaluation();
+        log << "Evaluating successors with "
+            << thread_pool.get_num_threads() << " threads" << endl;
+    }
 
     set<Evaluator *> evals;
     open_list->get_path_dependent_evaluators(evals);
@@ -114,7 +127,12 @@ SearchStatus EagerSearch::step() {
             log << "Completely explored state space -- no solution!" << endl;
             return FAILED;
         }
-        StateID id = open_list->remove_min();
+        StateID id = StateID::no_state;
+        {
+            ProfilingScope profiling_scope(
+                get_profiler(), SearchComponent::OPEN_LIST_REMOVAL);
+            id = open_list->remove_min();
+        }
         State s = state_registry.lookup_state(id);
         node.emplace(search_space.get_node(s));
 
@@ -172,13 +190,20 @@ SearchStatus EagerSearch::step() {
         return SOLVED;
 
     vector<OperatorID> applicable_ops;
-    successor_generator.generate_applicable_ops(s, applicable_ops);
+    {
+        ProfilingScope profiling_scope(
+            get_profiler(), SearchComponent::APPLICABLE_OPERATORS);
+        successor_generator.generate_applicable_ops(s, applicable_ops);
+    }
 
     /*
       TODO: When preferred operators are in use, a preferred operator will be
       considered by the preferred operator queues even when it is pruned.
     */
-    pruning_method->prune_operators(s, applicable_ops);
+    {
+        ProfilingScope profiling_scope(get_profiler(), SearchComponent::PRUNING);
+        pruning_method->prune_operators(s, applicable_ops);
+    }
 
     // This evaluates the expanded state (again) to get preferred ops
     EvaluationContext eval_context(s, node->get_g(), false, &statistics, true);
@@ -189,12 +214,35 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
-    for (OperatorID op_id : applicable_ops) {
-        OperatorProxy op = task_proxy.get_operators()[op_id];
-        if ((node->get_real_g() + op.get_cost()) >= bound)
-            continue;
+    OperatorsProxy operators = task_proxy.get_operators();
+    int real_g = node->get_real_g();
+    applicable_ops.erase(
+        remove_if(applicable_ops.begin(), applicable_ops.end(),
+                  [&](OperatorID op_id) {
+                      return real_g + operators[op_id].get_cost() >= bound;
+                  }),
+        applicable_ops.end());
+
+    vector<State> successors;
+    {
+        ProfilingScope profiling_scope(
+            get_profiler(), SearchComponent::SUCCESSOR_GENERATION);
+        state_registry.get_successor_states(s, applicable_ops, successors);
+    }
+    assert(successors.size() == applicable_ops.size());
+
+    vector<EvaluationContext> succ_eval_contexts;
+    vector<int> succ_eval_context_ids;
+    if (thread_pool.get_num_threads() > 1) {
+        evaluate_new_successors(
+            *node, applicable_ops, successors, preferred_operators,
+            succ_eval_contexts, succ_eval_context_ids);
+    }
 
-        State succ_state = state_registry.get_successor_state(s, op);
+    for (size_t i = 0; i < applicable_ops.size(); ++i) {
+        OperatorID op_id = applicable_ops[i];
+        OperatorProxy op = operators[op_id];
+        const State &succ_state = successors[i];
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
@@ -217,8 +265,15 @@ SearchStatus EagerSearch::step() {
             // TODO: Make this less fragile.
             int succ_g = node->get_g() + get_adjusted_cost(op);
 
-            EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
+            tl::optional<EvaluationContext> new_eval_context;
+            if (succ_eval_context_ids.empty()) {
+                new_eval_context.emplace(
+                    succ_state, succ_g, is_preferred, &statistics);
+            }
+            EvaluationContext &succ_eval_context = new_eval_context ?
+                *new_eval_context :
+                succ_eval_contexts[succ_eval_context_ids[i]];
+            assert(succ_eval_context.get_state().get_id() == succ_state.get_id());
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(succ_eval_context)) {
@@ -228,7 +283,11 @@ SearchStatus EagerSearch::step() {
             }
             succ_node.open(*node, op, get_adjusted_cost(op));
 
-            open_list->insert(succ_eval_context, succ_state.get_id());
+            {
+                ProfilingScope profiling_scope(
+                    get_profiler(), SearchComponent::OPEN_LIST_INSERTION);
+                open_list->insert(succ_eval_context, succ_state.get_id());
+            }
             if (search_progress.check_progress(succ_eval_context)) {
                 statistics.print_checkpoint_line(succ_node.get_g());
                 reward_progress();
@@ -268,6 +327,8 @@ SearchStatus EagerSearch::step() {
                   rather than a recomputation of the evaluator value
                   from scratch.
                 */
+                ProfilingScope profiling_scope(
+                    get_profiler(), SearchComponent::OPEN_LIST_INSERTION);
                 open_list->insert(succ_eval_context, succ_state.get_id());
             } else {
                 // If we do not reopen closed nodes, we just update the parent pointers.
@@ -281,6 +342,54 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+/*
+  Create the evaluation contexts of all successors that will be
+  evaluated in step() and evaluate them concurrently. Only the first
+  occurrence of each new successor state gets a context, because later
+  occurrences are no longer new when step() reaches them. Inserting the
+  successors into the open list still happens sequentially in step(), so
+  the search behaves exactly like the sequential search.
+
+  This is only valid because concurrent evaluation is restricted to
+  evaluators that are not path-dependent, so they don't need to be
+  notified about the state transitions first.
+*/
+void EagerSearch::evaluate_new_successors(
+    const SearchNode &node, const vector<OperatorID> &ops,
+    const vector<State> &successors,
+    const ordered_set::OrderedSet<OperatorID> &preferred_operators,
+    vector<EvaluationContext> &succ_eval_contexts,
+    vector<int> &succ_eval_context_ids) {
+    OperatorsProxy operators = task_proxy.get_operators();
+    succ_eval_context_ids.assign(ops.size(), -1);
+    succ_eval_contexts.reserve(ops.size());
+    vector<StateID> scheduled_states;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const State &succ_state = successors[i];
+        StateID succ_id = succ_state.get_id();
+        if (!search_space.get_node(succ_state).is_new()) {
+            continue;
+        }
+        auto it = find(scheduled_states.begin(), scheduled_states.end(), succ_id);
+        if (it != scheduled_states.end()) {
+            succ_eval_context_ids[i] = it - scheduled_states.begin();
+            continue;
+        }
+        int succ_g = node.get_g() + get_adjusted_cost(operators[ops[i]]);
+        bool is_preferred = preferred_operators.contains(ops[i]);
+        succ_eval_context_ids[i] = succ_eval_contexts.size();
+        succ_eval_contexts.emplace_back(
+            succ_state, succ_g, is_preferred, &statistics);
+        scheduled_states.push_back(succ_id);
+    }
+
+    thread_pool.parallel_for(
+        succ_eval_contexts.size(),
+        [this, &succ_eval_contexts](int i) {
+            open_list->is_dead_end(succ_eval_contexts[i]);
+        });
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -308,6 +417,16 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 }
 
 void add_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "num_threads",
+        "number of threads used to evaluate the successors of an expanded "
+        "state. Values larger than 1 require that all evaluators of the open "
+        "list support concurrent evaluation (e.g., blind, lmcut, pdb, cpdbs, "
+        "cegar and their combinations with g and sum/max/weight). The order "
+        "in which states are inserted into the open list does not depend on "
+        "the number of threads.",
+        "1",
+        plugins::Bounds("1", "infinity"));
     SearchEngine::add_pruning_option(feature);
     SearchEngine::add_options_to_feature(feature);
 }
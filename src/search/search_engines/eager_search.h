@@ -1,9 +1,13 @@
 #ifndef SEARCH_ENGINES_EAGER_SEARCH_H
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
+#include "../evaluation_context.h"
 #include "../open_list.h"
 #include "../search_engine.h"
 
+#include "../algorithms/ordered_set.h"
+#include "../utils/thread_pool.h"
+
 #include <memory>
 #include <vector>
 
@@ -27,6 +31,14 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    utils::ThreadPool thread_pool;
+
+    void evaluate_new_successors(
+        const SearchNode &node, const std::vector<OperatorID> &ops,
+        const std::vector<State> &successors,
+        const ordered_set::OrderedSet<OperatorID> &preferred_operators,
+        std::vector<EvaluationContext> &succ_eval_contexts,
+        std::vector<int> &succ_eval_context_ids);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -65,8 +65,12 @@ void LazySearch::initialize() {
 vector<OperatorID> LazySearch::get_successor_operators(
     const ordered_set::OrderedSet<OperatorID> &preferred_operators) const {
     vector<OperatorID> applicable_operators;
-    successor_generator.generate_applicable_ops(
-        current_state, applicable_operators);
+    {
+        ProfilingScope profiling_scope(
+            get_profiler(), SearchComponent::APPLICABLE_OPERATORS);
+        successor_generator.generate_applicable_ops(
+            current_state, applicable_operators);
+    }
 
     if (randomize_successors) {
         rng->shuffle(applicable_operators);
@@ -110,6 +114,8 @@ void LazySearch::generate_successors() {
         if (new_real_g < bound) {
             EvaluationContext new_eval_context(
                 current_eval_context, new_g, is_preferred, nullptr);
+            ProfilingScope profiling_scope(
+                get_profiler(), SearchComponent::OPEN_LIST_INSERTION);
             open_list->insert(new_eval_context, make_pair(current_state.get_id(), op_id));
         }
     }
@@ -121,14 +127,24 @@ SearchStatus LazySearch::fetch_next_state() {
         return FAILED;
     }
 
-    EdgeOpenListEntry next = open_list->remove_min();
+    EdgeOpenListEntry next(StateID::no_state, OperatorID::no_operator);
+    {
+        ProfilingScope profiling_scope(
+            get_profiler(), SearchComponent::OPEN_LIST_REMOVAL);
+        next = open_list->remove_min();
+    }
 
     current_predecessor_id = next.first;
     current_operator_id = next.second;
     State current_predecessor = state_registry.lookup_state(current_predecessor_id);
     OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
     assert(task_properties::is_applicable(current_operator, current_predecessor));
-    current_state = state_registry.get_successor_state(current_predecessor, current_operator);
+    {
+        ProfilingScope profiling_scope(
+            get_profiler(), SearchComponent::SUCCESSOR_GENERATION);
+        current_state = state_registry.get_successor_state(
+            current_predecessor, current_operator);
+    }
 
     SearchNode pred_node = search_space.get_node(current_predecessor);
     current_g = pred_node.get_g() + get_adjusted_cost(current_operator);
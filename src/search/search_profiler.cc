@@ -0,0 +1,201 @@
+#include "search_profiler.h"
+
+#include "evaluator.h"
+#include "search_statistics.h"
+#include "state_registry.h"
+
+#include "plugins/plugin.h"
+#include "utils/logging.h"
+#include "utils/system.h"
+
+#include <cassert>
+#include <sstream>
+
+using namespace std;
+
+static const vector<string> COMPONENT_NAMES = {
+    "applicable_operators",
+    "successor_generation",
+    "pruning",
+    "open_list_insertion",
+    "open_list_removal"
+};
+
+static void dump_json_string(ostream &os, const string &str) {
+    os << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (c == '\n') {
+            os << "\\n";
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+SearchProfiler::TimeProfile::TimeProfile()
+    : num_calls(0),
+      num_timed_calls(0),
+      timed_nanoseconds(0) {
+}
+
+void SearchProfiler::TimeProfile::dump_as_json(ostream &os) const {
+    int64_t calls = num_calls.load(memory_order_relaxed);
+    int64_t timed_calls = num_timed_calls.load(memory_order_relaxed);
+    double timed_seconds = timed_nanoseconds.load(memory_order_relaxed) / 1e9;
+    double estimated_seconds = 0;
+    if (timed_calls > 0) {
+        estimated_seconds = timed_seconds * calls / timed_calls;
+    }
+    os << "{\"calls\": " << calls
+       << ", \"timed_calls\": " << timed_calls
+       << ", \"timed_seconds\": " << timed_seconds
+       << ", \"estimated_seconds\": " << estimated_seconds << "}";
+}
+
+SearchProfiler::SearchProfiler(
+    const plugins::Options &opts, utils::LogProxy &log,
+    const StateRegistry &state_registry, const SearchStatistics &statistics)
+    : output(opts.get<ProfileOutput>("profile")),
+      sampling_interval(opts.get<int>("profile_sampling_interval")),
+      log(log),
+      state_registry(state_registry),
+      statistics(statistics) {
+    if (is_enabled()) {
+        /*
+          All evaluators used by the search engine have been created at
+          this point. Evaluators created later are not profiled.
+        */
+        int num_evaluators = Evaluator::get_num_evaluators();
+        component_profiles = vector<TimeProfile>(COMPONENT_NAMES.size());
+        evaluator_profiles = vector<TimeProfile>(num_evaluators);
+        evaluators = vector<atomic<const Evaluator *>>(num_evaluators);
+    }
+}
+
+SearchProfiler::TimeProfile *SearchProfiler::start_call(SearchComponent component) {
+    assert(is_enabled());
+    TimeProfile &profile = component_profiles[static_cast<int>(component)];
+    int64_t call = profile.num_calls.fetch_add(1, memory_order_relaxed);
+    return (call % sampling_interval == 0) ? &profile : nullptr;
+}
+
+SearchProfiler::TimeProfile *SearchProfiler::start_call(const Evaluator *evaluator) {
+    assert(is_enabled());
+    int id = evaluator->get_id();
+    if (id >= static_cast<int>(evaluator_profiles.size())) {
+        return nullptr;
+    }
+    evaluators[id].store(evaluator, memory_order_relaxed);
+    TimeProfile &profile = evaluator_profiles[id];
+    int64_t call = profile.num_calls.fetch_add(1, memory_order_relaxed);
+    return (call % sampling_interval == 0) ? &profile : nullptr;
+}
+
+void SearchProfiler::dump_as_json(ostream &os) const {
+    os << "{\"time\": " << static_cast<double>(timer())
+       << ", \"sampling_interval\": " << sampling_interval;
+
+    os << ", \"statistics\": {"
+       << "\"expanded\": " << statistics.get_expanded()
+       << ", \"evaluated\": " << statistics.get_evaluated_states()
+       << ", \"evaluations\": " << statistics.get_evaluations()
+       << ", \"generated\": " << statistics.get_generated()
+       << ", \"reopened\": " << statistics.get_reopened()
+       << "}";
+
+    os << ", \"components\": {";
+    for (size_t i = 0; i < COMPONENT_NAMES.size(); ++i) {
+        if (i > 0) {
+            os << ", ";
+        }
+        dump_json_string(os, COMPONENT_NAMES[i]);
+        os << ": ";
+        component_profiles[i].dump_as_json(os);
+    }
+    os << "}";
+
+    os << ", \"evaluators\": [";
+    bool first = true;
+    for (size_t id = 0; id < evaluators.size(); ++id) {
+        const Evaluator *evaluator = evaluators[id].load(memory_order_relaxed);
+        if (!evaluator) {
+            continue;
+        }
+        if (!first) {
+            os << ", ";
+        }
+        first = false;
+        os << "{\"id\": " << id << ", \"description\": ";
+        dump_json_string(os, evaluator->get_description());
+        os << ", \"time\": ";
+        evaluator_profiles[id].dump_as_json(os);
+        os << "}";
+    }
+    os << "]";
+
+    StateRegistry::HashSetStatistics hash_set = state_registry.get_hash_set_statistics();
+    double average_probe_length = 0;
+    if (hash_set.num_lookups > 0) {
+        average_probe_length =
+            static_cast<double>(hash_set.total_probe_length) / hash_set.num_lookups;
+    }
+    os << ", \"state_registry\": {"
+       << "\"registered_states\": " << state_registry.size()
+       << ", \"state_size_in_bytes\": " << state_registry.get_state_size_in_bytes()
+       << ", \"state_data_bytes\": "
+       << static_cast<int64_t>(state_registry.size()) *
+        state_registry.get_state_size_in_bytes()
+       << ", \"hash_set_capacity\": " << hash_set.capacity
+       << ", \"hash_set_resizes\": " << hash_set.num_resizes
+       << ", \"hash_set_lookups\": " << hash_set.num_lookups
+       << ", \"average_probe_length\": " << average_probe_length
+       << ", \"max_probe_length\": " << hash_set.max_probe_length
+       << "}";
+
+    os << ", \"peak_memory_kb\": " << utils::get_peak_memory_in_kb() << "}";
+}
+
+void SearchProfiler::report_checkpoint(int g) {
+    if (output == ProfileOutput::CHECKPOINTS) {
+        ostringstream json;
+        dump_as_json(json);
+        log << "Search profile at checkpoint g=" << g << ": "
+            << json.str() << endl;
+    }
+}
+
+void SearchProfiler::report_final_profile() {
+    if (is_enabled()) {
+        ostringstream json;
+        dump_as_json(json);
+        log << "Search profile: " << json.str() << endl;
+    }
+}
+
+void add_profiler_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<ProfileOutput>(
+        "profile",
+        "profile the time spent in the components of the search (computing "
+        "applicable operators, generating and registering successor states, "
+        "pruning, open list operations and each evaluator) and the hash set "
+        "used for duplicate detection. The profile is written to the log as "
+        "JSON.",
+        "none");
+    feature.add_option<int>(
+        "profile_sampling_interval",
+        "only measure the time of every k-th call of each profiled component "
+        "and extrapolate the total time from these calls. All calls are "
+        "counted. Use larger values to reduce the profiling overhead.",
+        "1",
+        plugins::Bounds("1", "infinity"));
+}
+
+static plugins::TypedEnumPlugin<ProfileOutput> _enum_plugin({
+        {"none", "do not profile the search"},
+        {"final", "write the profile at the end of the search"},
+        {"checkpoints", "write the profile at the end of the search and "
+         "whenever the search reports progress"}
+    });
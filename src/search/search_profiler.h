@@ -0,0 +1,139 @@
+#ifndef SEARCH_PROFILER_H
+#define SEARCH_PROFILER_H
+
+#include "utils/timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Evaluator;
+class SearchStatistics;
+class StateRegistry;
+
+namespace plugins {
+class Feature;
+class Options;
+}
+
+namespace utils {
+class LogProxy;
+}
+
+enum class ProfileOutput {
+    NONE,
+    FINAL,
+    CHECKPOINTS
+};
+
+/*
+  Successor generation covers creating the successor states and looking
+  them up in the state registry, which includes duplicate detection. The
+  probe statistics of the registry's hash set are reported separately.
+*/
+enum class SearchComponent {
+    APPLICABLE_OPERATORS,
+    SUCCESSOR_GENERATION,
+    PRUNING,
+    OPEN_LIST_INSERTION,
+    OPEN_LIST_REMOVAL
+};
+
+/*
+  Opt-in profiling of the components of a search engine.
+
+  For each search component and each evaluator, the profiler counts the
+  number of calls and measures the time spent in every k-th call, where
+  k is the sampling interval (k = 1 measures all calls). The total time
+  is estimated from the measured calls. Evaluator times include the
+  time of their subevaluators. All counters are atomic, so evaluators
+  may be profiled while they are evaluated concurrently.
+
+  The profile is written to the log as a single line of JSON at the end
+  of the search and, if requested, whenever the search reports progress
+  (see SearchStatistics::print_checkpoint_line()).
+*/
+class SearchProfiler {
+public:
+    struct TimeProfile {
+        std::atomic<int64_t> num_calls;
+        std::atomic<int64_t> num_timed_calls;
+        std::atomic<int64_t> timed_nanoseconds;
+
+        TimeProfile();
+        void dump_as_json(std::ostream &os) const;
+    };
+
+private:
+    const ProfileOutput output;
+    const int sampling_interval;
+    utils::LogProxy &log;
+    const StateRegistry &state_registry;
+    const SearchStatistics &statistics;
+    utils::Timer timer;
+
+    std::vector<TimeProfile> component_profiles;
+    // Indexed by Evaluator::get_id().
+    std::vector<TimeProfile> evaluator_profiles;
+    std::vector<std::atomic<const Evaluator *>> evaluators;
+
+    void dump_as_json(std::ostream &os) const;
+public:
+    SearchProfiler(
+        const plugins::Options &opts, utils::LogProxy &log,
+        const StateRegistry &state_registry,
+        const SearchStatistics &statistics);
+
+    bool is_enabled() const {
+        return output != ProfileOutput::NONE;
+    }
+
+    /*
+      Return the profile for the given component or evaluator if the
+      current call should be timed and nullptr otherwise. The call is
+      counted in both cases.
+    */
+    TimeProfile *start_call(SearchComponent component);
+    TimeProfile *start_call(const Evaluator *evaluator);
+
+    void report_checkpoint(int g);
+    void report_final_profile();
+};
+
+/*
+  Measure the time until the end of the enclosing scope and add it to the
+  given component or evaluator. Passing a null profiler disables the
+  measurement.
+*/
+class ProfilingScope {
+    SearchProfiler::TimeProfile *profile;
+    std::chrono::steady_clock::time_point start;
+public:
+    template<typename Component>
+    ProfilingScope(SearchProfiler *profiler, const Component &component)
+        : profile(profiler ? profiler->start_call(component) : nullptr) {
+        if (profile) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ProfilingScope() {
+        if (profile) {
+            std::chrono::nanoseconds duration =
+                std::chrono::steady_clock::now() - start;
+            profile->num_timed_calls.fetch_add(1, std::memory_order_relaxed);
+            profile->timed_nanoseconds.fetch_add(
+                duration.count(), std::memory_order_relaxed);
+        }
+    }
+
+    ProfilingScope(const ProfilingScope &) = delete;
+    ProfilingScope &operator=(const ProfilingScope &) = delete;
+};
+
+extern void add_profiler_options_to_feature(plugins::Feature &feature);
+
+#endif
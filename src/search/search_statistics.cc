@@ -1,5 +1,7 @@
 #include "search_statistics.h"
 
+#include "search_profiler.h"
+
 #include "utils/logging.h"
 #include "utils/timer.h"
 #include "utils/system.h"
@@ -10,7 +12,8 @@ using namespace std;
 
 
 SearchStatistics::SearchStatistics(utils::LogProxy &log)
-    : log(log) {
+    : log(log),
+      profiler(nullptr) {
     expanded_states = 0;
     reopened_states = 0;
     evaluated_states = 0;
@@ -53,6 +56,9 @@ void SearchStatistics::print_checkpoint_line(int g) const {
         print_basic_statistics();
         log << endl;
     }
+    if (profiler) {
+        profiler->report_checkpoint(g);
+    }
 }
 
 void SearchStatistics::print_basic_statistics() const {
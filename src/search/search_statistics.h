@@ -9,17 +9,24 @@
   methods.
 */
 
+#include <atomic>
+
+class SearchProfiler;
+
 namespace utils {
 class LogProxy;
 }
 
 class SearchStatistics {
     utils::LogProxy &log;
+    // Only set if profiling is enabled.
+    SearchProfiler *profiler;
 
     // General statistics
     int expanded_states;  // no states for which successors were generated
     int evaluated_states; // no states for which h fn was computed
-    int evaluations;      // no of heuristic evaluations performed
+    // no of heuristic evaluations performed (may be counted concurrently)
+    std::atomic<int> evaluations;
     int generated_states; // no states created in total (plus those removed since already in close list)
     int reopened_states;  // no of *closed* states which we reopened
     int dead_end_states;
@@ -38,6 +45,9 @@ public:
     explicit SearchStatistics(utils::LogProxy &log);
     ~SearchStatistics() = default;
 
+    void set_profiler(SearchProfiler *profiler_) {profiler = profiler_;}
+    SearchProfiler *get_profiler() const {return profiler;}
+
     // Methods that update statistics.
     void inc_expanded(int inc = 1) {expanded_states += inc;}
     void inc_evaluated_states(int inc = 1) {evaluated_states += inc;}
@@ -6,6 +6,8 @@
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
 
+#include <algorithm>
+
 using namespace std;
 
 StateRegistry::StateRegistry(const TaskProxy &task_proxy)
@@ -17,6 +19,66 @@ StateRegistry::StateRegistry(const TaskProxy &task_proxy)
       registered_states(
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+    if (!task_properties::has_axioms(task_proxy)) {
+        compute_bin_effects();
+    }
+}
+
+void StateRegistry::compute_bin_effects() {
+    OperatorsProxy operators = task_proxy.get_operators();
+    has_bin_effects.resize(operators.size(), false);
+    bin_effects_by_operator.resize(operators.size());
+    for (OperatorProxy op : operators) {
+        EffectsProxy effects = op.get_effects();
+        bool has_conditional_effect = false;
+        for (EffectProxy effect : effects) {
+            if (!effect.get_conditions().empty()) {
+                has_conditional_effect = true;
+                break;
+            }
+        }
+        if (has_conditional_effect) {
+            continue;
+        }
+        vector<BinEffect> &bin_effects = bin_effects_by_operator[op.get_id()];
+        for (EffectProxy effect : effects) {
+            FactPair fact = effect.get_fact().get_pair();
+            int bin_index = state_packer.get_bin_index(fact.var);
+            auto it = find_if(
+                bin_effects.begin(), bin_effects.end(),
+                [bin_index](const BinEffect &bin_effect) {
+                    return bin_effect.bin_index == bin_index;
+                });
+            if (it == bin_effects.end()) {
+                bin_effects.push_back({bin_index, ~PackedStateBin(0), 0});
+                it = bin_effects.end() - 1;
+            }
+            it->clear_mask &= ~state_packer.get_read_mask(fact.var);
+            it->value_bits |= state_packer.get_value_bits(fact.var, fact.value);
+        }
+        bin_effects.shrink_to_fit();
+        has_bin_effects[op.get_id()] = true;
+    }
+}
+
+void StateRegistry::apply_effects(
+    const State &predecessor, OperatorID op_id, PackedStateBin *buffer) const {
+    assert(!task_properties::has_axioms(task_proxy));
+    int op_index = op_id.get_index();
+    if (has_bin_effects[op_index]) {
+        for (const BinEffect &bin_effect : bin_effects_by_operator[op_index]) {
+            PackedStateBin &bin = buffer[bin_effect.bin_index];
+            bin = (bin & bin_effect.clear_mask) | bin_effect.value_bits;
+        }
+    } else {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+            }
+        }
+    }
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -36,6 +98,18 @@ StateID StateRegistry::insert_id_or_pop_state() {
     return StateID(result.first);
 }
 
+StateID StateRegistry::insert_id_or_pop_state(int_hash_set::HashType hash) {
+    // Like insert_id_or_pop_state(), but with a precomputed hash value.
+    StateID id(state_data_pool.size() - 1);
+    pair<int, bool> result = registered_states.insert_with_hash(id.value, hash);
+    bool is_new_entry = result.second;
+    if (!is_new_entry) {
+        state_data_pool.pop_back();
+    }
+    assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
+    return StateID(result.first);
+}
+
 State StateRegistry::lookup_state(StateID id) const {
     const PackedStateBin *buffer = state_data_pool[id.value];
     return task_proxy.create_state(*this, id, buffer);
@@ -82,16 +156,55 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
             state_packer.set(buffer, i, new_values[i]);
         }
         StateID id = insert_id_or_pop_state();
-        return task_proxy.create_state(*this, id, buffer, move(new_values));
+        /*
+          We must not use buffer after insert_id_or_pop_state() because it
+          may have been popped from the pool if the state is a duplicate.
+        */
+        return task_proxy.create_state(
+            *this, id, state_data_pool[id.value], move(new_values));
     } else {
-        for (EffectProxy effect : op.get_effects()) {
-            if (does_fire(effect, predecessor)) {
-                FactPair effect_pair = effect.get_fact().get_pair();
-                state_packer.set(buffer, effect_pair.var, effect_pair.value);
-            }
-        }
+        apply_effects(predecessor, OperatorID(op.get_id()), buffer);
         StateID id = insert_id_or_pop_state();
-        return task_proxy.create_state(*this, id, buffer);
+        return lookup_state(id);
+    }
+}
+
+void StateRegistry::get_successor_states(
+    const State &predecessor, const vector<OperatorID> &op_ids,
+    vector<State> &successors) {
+    if (task_properties::has_axioms(task_proxy)) {
+        OperatorsProxy operators = task_proxy.get_operators();
+        for (OperatorID op_id : op_ids) {
+            successors.push_back(
+                get_successor_state(predecessor, operators[op_id]));
+        }
+        return;
+    }
+
+    /*
+      First build and hash all successors in scratch memory and prefetch
+      their hash buckets, then register them one after the other. This way,
+      the cache misses of the duplicate checks overlap with each other and
+      with the successor construction.
+    */
+    int num_bins = get_bins_per_state();
+    int num_successors = op_ids.size();
+    const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+    successor_buffers.resize(num_successors * num_bins);
+    successor_hashes.resize(num_successors);
+    for (int i = 0; i < num_successors; ++i) {
+        PackedStateBin *buffer = successor_buffers.data() + i * num_bins;
+        copy(predecessor_buffer, predecessor_buffer + num_bins, buffer);
+        apply_effects(predecessor, op_ids[i], buffer);
+        successor_hashes[i] = StateIDSemanticHash::hash_buffer(buffer, num_bins);
+        registered_states.prefetch_bucket(successor_hashes[i]);
+    }
+
+    successors.reserve(successors.size() + num_successors);
+    for (int i = 0; i < num_successors; ++i) {
+        state_data_pool.push_back(successor_buffers.data() + i * num_bins);
+        StateID id = insert_id_or_pop_state(successor_hashes[i]);
+        successors.push_back(lookup_state(id));
     }
 }
 
@@ -103,6 +216,20 @@ int StateRegistry::get_state_size_in_bytes() const {
     return get_bins_per_state() * sizeof(PackedStateBin);
 }
 
+StateRegistry::HashSetStatistics StateRegistry::get_hash_set_statistics() const {
+    HashSetStatistics statistics;
+    statistics.capacity = registered_states.get_capacity();
+    statistics.num_resizes = registered_states.get_num_resizes();
+    statistics.num_lookups = registered_states.get_num_insert_calls();
+    statistics.total_probe_length = registered_states.get_total_probe_length();
+    statistics.max_probe_length = registered_states.get_max_probe_length();
+    return statistics;
+}
+
+void StateRegistry::enable_hash_set_statistics() {
+    registered_states.enable_probe_statistics();
+}
+
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
     registered_states.print_statistics(log);
@@ -3,6 +3,7 @@
 
 #include "abstract_task.h"
 #include "axioms.h"
+#include "operator_id.h"
 #include "state_id.h"
 
 #include "algorithms/int_hash_set.h"
@@ -12,6 +13,7 @@
 #include "utils/hash.h"
 
 #include <set>
+#include <vector>
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -123,14 +125,18 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
               state_size(state_size) {
         }
 
-        int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
+        static int_hash_set::HashType hash_buffer(
+            const PackedStateBin *data, int state_size) {
             utils::HashState hash_state;
             for (int i = 0; i < state_size; ++i) {
                 hash_state.feed(data[i]);
             }
             return hash_state.get_hash32();
         }
+
+        int_hash_set::HashType operator()(int id) const {
+            return hash_buffer(state_data_pool[id], state_size);
+        }
     };
 
     struct StateIDSemanticEqual {
@@ -167,7 +173,30 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
 
     std::unique_ptr<State> cached_initial_state;
 
+    /*
+      The effects of an operator without conditional effects, grouped by
+      the bins they write to. Applying such an operator to a packed state
+      takes one masked write per touched bin. Operators with conditional
+      effects have no entry in bin_effects_by_operator and are applied
+      effect by effect.
+    */
+    struct BinEffect {
+        int bin_index;
+        PackedStateBin clear_mask;
+        PackedStateBin value_bits;
+    };
+    std::vector<bool> has_bin_effects;
+    std::vector<std::vector<BinEffect>> bin_effects_by_operator;
+
+    // Scratch space for get_successor_states(), reused across calls.
+    std::vector<PackedStateBin> successor_buffers;
+    std::vector<int_hash_set::HashType> successor_hashes;
+
+    void compute_bin_effects();
+    void apply_effects(
+        const State &predecessor, OperatorID op_id, PackedStateBin *buffer) const;
     StateID insert_id_or_pop_state();
+    StateID insert_id_or_pop_state(int_hash_set::HashType hash);
     int get_bins_per_state() const;
 public:
     explicit StateRegistry(const TaskProxy &task_proxy);
@@ -203,6 +232,17 @@ public:
     */
     State get_successor_state(const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Computes and registers the successors of predecessor for all given
+      operators (in the given order) and appends them to successors. This
+      is equivalent to calling get_successor_state() for each operator, but
+      builds all successor buffers first and prefetches the hash buckets
+      needed for duplicate checking before any of them is probed.
+    */
+    void get_successor_states(
+        const State &predecessor, const std::vector<OperatorID> &op_ids,
+        std::vector<State> &successors);
+
     /*
       Returns the number of states registered so far.
     */
@@ -212,6 +252,22 @@ public:
 
     int get_state_size_in_bytes() const;
 
+    /*
+      Statistics of the hash set used for duplicate detection. The probe
+      length of a lookup is the distance of the bucket holding the state
+      from its ideal bucket.
+    */
+    struct HashSetStatistics {
+        int capacity;
+        int num_resizes;
+        int64_t num_lookups;
+        int64_t total_probe_length;
+        int max_probe_length;
+    };
+    HashSetStatistics get_hash_set_statistics() const;
+    // Probe statistics are only collected after calling this method.
+    void enable_hash_set_statistics();
+
     void print_statistics(utils::LogProxy &log) const;
 
     class const_iterator {
@@ -0,0 +1,69 @@
+#include "fact_tuple_ranking.h"
+
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace fact_tuple_ranking {
+FactTupleRanking::FactTupleRanking(
+    const VariablesProxy &variables, int max_size)
+    : max_size(max_size) {
+    assert(max_size >= 1);
+    fact_offsets.reserve(variables.size() + 1);
+    fact_offsets.push_back(0);
+    vector<int> var_of_fact;
+    for (VariableProxy var : variables) {
+        var_of_fact.insert(var_of_fact.end(), var.get_domain_size(), var.get_id());
+        fact_offsets.push_back(fact_offsets.back() + var.get_domain_size());
+    }
+    int num_facts = fact_offsets.back();
+
+    /*
+      Tuples are numbered by size and the children of a tuple directly
+      follow the children of the previous tuple. We store the last
+      variable of all tuples that can be extended.
+    */
+    vector<int> last_vars;
+    if (max_size > 1) {
+        last_vars = var_of_fact;
+    }
+    int64_t num_tuples_64 = num_facts;
+    int64_t level_begin = 0;
+    int64_t level_end = num_facts;
+    for (int size = 1; size < max_size && level_begin < level_end; ++size) {
+        for (int64_t tuple_id = level_begin; tuple_id < level_end; ++tuple_id) {
+            int first_child_fact = fact_offsets[last_vars[tuple_id] + 1];
+            child_offsets.push_back(num_tuples_64);
+            num_tuples_64 += num_facts - first_child_fact;
+            if (num_tuples_64 > numeric_limits<int>::max()) {
+                cerr << "There are too many tuples of at most " << max_size
+                     << " facts to rank them." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+            }
+            if (size + 1 < max_size) {
+                last_vars.insert(last_vars.end(),
+                                 var_of_fact.begin() + first_child_fact,
+                                 var_of_fact.end());
+            }
+        }
+        level_begin = level_end;
+        level_end = num_tuples_64;
+    }
+    num_tuples = num_tuples_64;
+}
+
+int FactTupleRanking::get_tuple_id(const vector<FactPair> &tuple) const {
+    assert(!tuple.empty() && static_cast<int>(tuple.size()) <= max_size);
+    int tuple_id = get_fact_id(tuple[0]);
+    for (size_t i = 1; i < tuple.size(); ++i) {
+        assert(tuple[i - 1].var < tuple[i].var);
+        tuple_id = get_child_id(tuple_id, tuple[i - 1].var, tuple[i]);
+    }
+    return tuple_id;
+}
+}
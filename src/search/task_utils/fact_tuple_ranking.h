@@ -0,0 +1,53 @@
+#ifndef TASK_UTILS_FACT_TUPLE_RANKING_H
+#define TASK_UTILS_FACT_TUPLE_RANKING_H
+
+#include "../task_proxy.h"
+
+#include <vector>
+
+namespace fact_tuple_ranking {
+/*
+  Assign a unique ID in {0, ..., N - 1} to each tuple of 1 to max_size
+  facts over pairwise different variables, where N is the number of such
+  tuples. Tuples must be sorted by variable.
+
+  We rank the tuples like the nodes of a trie: the tuples of size 1 are
+  the facts themselves, and the children of a tuple t with last variable
+  v are the tuples t + [f] for all facts f of variables larger than v.
+  Since these facts form a contiguous range of fact IDs, the children of
+  t occupy a contiguous range of tuple IDs starting at child_offsets[t].
+  Computing the ID of a tuple of size k therefore takes k array lookups.
+*/
+class FactTupleRanking {
+    int max_size;
+    // Facts of variable var have the IDs fact_offsets[var] + value.
+    std::vector<int> fact_offsets;
+    std::vector<int> child_offsets;
+    int num_tuples;
+
+public:
+    FactTupleRanking(const VariablesProxy &variables, int max_size);
+
+    int get_fact_id(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    // Return the ID of the tuple that extends the given tuple by fact.
+    int get_child_id(int tuple_id, int last_var, const FactPair &fact) const {
+        return child_offsets[tuple_id] + get_fact_id(fact) -
+               fact_offsets[last_var + 1];
+    }
+
+    int get_tuple_id(const std::vector<FactPair> &tuple) const;
+
+    int get_num_facts() const {
+        return fact_offsets.back();
+    }
+
+    int get_num_tuples() const {
+        return num_tuples;
+    }
+};
+}
+
+#endif
@@ -3,21 +3,40 @@
 #include "successor_generator_factory.h"
 #include "successor_generator_internals.h"
 
+#include "task_properties.h"
+
 #include "../abstract_task.h"
+#include "../state_registry.h"
 
 using namespace std;
 
 namespace successor_generator {
 SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+    : generator(SuccessorGeneratorFactory(task_proxy).create()),
+      state_packer(task_properties::g_state_packers[task_proxy]) {
+    int num_variables = task_proxy.get_variables().size();
+    packed_variables.reserve(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        packed_variables.push_back(
+            {state_packer.get_bin_index(var), state_packer.get_shift(var),
+             state_packer.get_read_mask(var)});
+    }
 }
 
 SuccessorGenerator::~SuccessorGenerator() = default;
 
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
-    state.unpack();
-    root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
+    const StateRegistry *registry = state.get_registry();
+    if (registry && &registry->get_state_packer() == &state_packer) {
+        generator->generate_applicable_ops(
+            PackedValueReader(state.get_buffer(), packed_variables),
+            applicable_ops);
+    } else {
+        state.unpack();
+        generator->generate_applicable_ops(
+            UnpackedValueReader(state.get_unpacked_values()), applicable_ops);
+    }
 }
 
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
@@ -10,17 +10,29 @@ class OperatorID;
 class State;
 class TaskProxy;
 
+namespace int_packer {
+class IntPacker;
+}
+
 namespace successor_generator {
-class GeneratorBase;
+class CompiledGenerator;
+struct PackedVariable;
 
 class SuccessorGenerator {
-    std::unique_ptr<GeneratorBase> root;
+    std::unique_ptr<CompiledGenerator> generator;
+    /*
+      Layout of the variables in packed states of this task. Registered
+      states packed with this state packer are evaluated directly on their
+      packed data, all other states are unpacked first.
+    */
+    const int_packer::IntPacker &state_packer;
+    std::vector<PackedVariable> packed_variables;
 
 public:
     explicit SuccessorGenerator(const TaskProxy &task_proxy);
     /*
       We cannot use the default destructor (implicitly or explicitly)
-      here because GeneratorBase is a forward declaration and the
+      here because CompiledGenerator is a forward declaration and the
       incomplete type cannot be destroyed.
     */
     ~SuccessorGenerator();
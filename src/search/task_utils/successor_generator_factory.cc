@@ -4,7 +4,6 @@
 
 #include "../task_proxy.h"
 
-#include "../utils/collections.h"
 #include "../utils/memory.h"
 
 #include <algorithm>
@@ -172,23 +171,17 @@ SuccessorGeneratorFactory::SuccessorGeneratorFactory(
 
 SuccessorGeneratorFactory::~SuccessorGeneratorFactory() = default;
 
-GeneratorPtr SuccessorGeneratorFactory::construct_fork(
-    vector<GeneratorPtr> nodes) const {
-    int size = nodes.size();
-    if (size == 1) {
-        return move(nodes.at(0));
-    } else if (size == 2) {
-        return utils::make_unique_ptr<GeneratorForkBinary>(
-            move(nodes.at(0)), move(nodes.at(1)));
+int SuccessorGeneratorFactory::construct_fork(const vector<int> &nodes) {
+    if (nodes.size() == 1) {
+        return nodes.front();
     } else {
         /* This general case includes the case size == 0, which can
            (only) happen for the root for tasks with no operators. */
-        return utils::make_unique_ptr<GeneratorForkMulti>(move(nodes));
+        return generator->add_fork(nodes);
     }
 }
 
-GeneratorPtr SuccessorGeneratorFactory::construct_leaf(
-    OperatorRange range) const {
+int SuccessorGeneratorFactory::construct_leaf(OperatorRange range) {
     assert(!range.empty());
     vector<OperatorID> operators;
     operators.reserve(range.span());
@@ -196,49 +189,43 @@ GeneratorPtr SuccessorGeneratorFactory::construct_leaf(
         operators.emplace_back(operator_infos[range.begin].get_op());
         ++range.begin;
     }
-
-    if (operators.size() == 1) {
-        return utils::make_unique_ptr<GeneratorLeafSingle>(operators.front());
-    } else {
-        return utils::make_unique_ptr<GeneratorLeafVector>(move(operators));
-    }
+    return generator->add_leaf(operators);
 }
 
-GeneratorPtr SuccessorGeneratorFactory::construct_switch(
-    int switch_var_id, ValuesAndGenerators values_and_generators) const {
+int SuccessorGeneratorFactory::construct_switch(
+    int switch_var_id, const ValuesAndNodes &values_and_nodes) {
     VariablesProxy variables = task_proxy.get_variables();
     int var_domain = variables[switch_var_id].get_domain_size();
-    int num_children = values_and_generators.size();
+    int num_children = values_and_nodes.size();
 
     assert(num_children > 0);
 
     if (num_children == 1) {
-        int value = values_and_generators[0].first;
-        GeneratorPtr generator = move(values_and_generators[0].second);
-        return utils::make_unique_ptr<GeneratorSwitchSingle>(
-            switch_var_id, value, move(generator));
+        return generator->add_switch_single(
+            switch_var_id, values_and_nodes[0].first,
+            values_and_nodes[0].second);
     }
 
-    int vector_bytes = utils::estimate_vector_bytes<GeneratorPtr>(var_domain);
-    int hash_bytes = utils::estimate_unordered_map_bytes<int, GeneratorPtr>(num_children);
-    if (hash_bytes < vector_bytes) {
-        unordered_map<int, GeneratorPtr> generator_by_value;
-        for (auto &item : values_and_generators)
-            generator_by_value[item.first] = move(item.second);
-        return utils::make_unique_ptr<GeneratorSwitchHash>(
-            switch_var_id, move(generator_by_value));
+    /*
+      Dense switches need one lookup per evaluation, sparse switches need
+      a binary search. We therefore prefer dense switches unless they use
+      more than four times the memory of the corresponding sparse switch.
+    */
+    int dense_entries = var_domain;
+    int sparse_entries = 2 * num_children;
+    if (dense_entries > 4 * sparse_entries) {
+        return generator->add_switch_sparse(switch_var_id, values_and_nodes);
     } else {
-        vector<GeneratorPtr> generator_by_value(var_domain);
-        for (auto &item : values_and_generators)
-            generator_by_value[item.first] = move(item.second);
-        return utils::make_unique_ptr<GeneratorSwitchVector>(
-            switch_var_id, move(generator_by_value));
+        vector<int> node_by_value(var_domain, CompiledGenerator::NO_CHILD);
+        for (const auto &item : values_and_nodes)
+            node_by_value[item.first] = item.second;
+        return generator->add_switch_dense(switch_var_id, node_by_value);
     }
 }
 
-GeneratorPtr SuccessorGeneratorFactory::construct_recursive(
-    int depth, OperatorRange range) const {
-    vector<GeneratorPtr> nodes;
+int SuccessorGeneratorFactory::construct_recursive(
+    int depth, OperatorRange range) {
+    vector<int> nodes;
     OperatorGrouper grouper_by_var(
         operator_infos, depth, GroupOperatorsBy::VAR, range);
     while (!grouper_by_var.done()) {
@@ -251,7 +238,7 @@ GeneratorPtr SuccessorGeneratorFactory::construct_recursive(
             nodes.push_back(construct_leaf(var_range));
         } else {
             // Handle a group of operators sharing the first precondition variable.
-            ValuesAndGenerators values_and_generators;
+            ValuesAndNodes values_and_nodes;
             OperatorGrouper grouper_by_value(
                 operator_infos, depth, GroupOperatorsBy::VALUE, var_range);
             while (!grouper_by_value.done()) {
@@ -259,15 +246,14 @@ GeneratorPtr SuccessorGeneratorFactory::construct_recursive(
                 int value = value_group.first;
                 OperatorRange value_range = value_group.second;
 
-                values_and_generators.emplace_back(
+                values_and_nodes.emplace_back(
                     value, construct_recursive(depth + 1, value_range));
             }
 
-            nodes.push_back(construct_switch(
-                                var, move(values_and_generators)));
+            nodes.push_back(construct_switch(var, values_and_nodes));
         }
     }
-    return construct_fork(move(nodes));
+    return construct_fork(nodes);
 }
 
 static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
@@ -280,7 +266,8 @@ static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
     return precond;
 }
 
-GeneratorPtr SuccessorGeneratorFactory::create() {
+unique_ptr<CompiledGenerator> SuccessorGeneratorFactory::create() {
+    generator = utils::make_unique_ptr<CompiledGenerator>();
     OperatorsProxy operators = task_proxy.get_operators();
     operator_infos.reserve(operators.size());
     for (OperatorProxy op : operators) {
@@ -292,8 +279,8 @@ GeneratorPtr SuccessorGeneratorFactory::create() {
     stable_sort(operator_infos.begin(), operator_infos.end());
 
     OperatorRange full_range(0, operator_infos.size());
-    GeneratorPtr root = construct_recursive(0, full_range);
+    generator->set_root(construct_recursive(0, full_range));
     operator_infos.clear();
-    return root;
+    return move(generator);
 }
 }
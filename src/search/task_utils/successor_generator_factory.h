@@ -7,30 +7,32 @@
 class TaskProxy;
 
 namespace successor_generator {
-class GeneratorBase;
-
-using GeneratorPtr = std::unique_ptr<GeneratorBase>;
+class CompiledGenerator;
 
 struct OperatorRange;
 class OperatorInfo;
 
 
+/*
+  Nodes of the generator are identified by their offset in the compiled
+  generator (see CompiledGenerator).
+*/
 class SuccessorGeneratorFactory {
-    using ValuesAndGenerators = std::vector<std::pair<int, GeneratorPtr>>;
+    using ValuesAndNodes = std::vector<std::pair<int, int>>;
 
     const TaskProxy &task_proxy;
     std::vector<OperatorInfo> operator_infos;
+    std::unique_ptr<CompiledGenerator> generator;
 
-    GeneratorPtr construct_fork(std::vector<GeneratorPtr> nodes) const;
-    GeneratorPtr construct_leaf(OperatorRange range) const;
-    GeneratorPtr construct_switch(
-        int switch_var_id, ValuesAndGenerators values_and_generators) const;
-    GeneratorPtr construct_recursive(int depth, OperatorRange range) const;
+    int construct_fork(const std::vector<int> &nodes);
+    int construct_leaf(OperatorRange range);
+    int construct_switch(int switch_var_id, const ValuesAndNodes &values_and_nodes);
+    int construct_recursive(int depth, OperatorRange range);
 public:
     explicit SuccessorGeneratorFactory(const TaskProxy &task_proxy);
     // Destructor cannot be implicit because OperatorInfo is forward-declared.
     ~SuccessorGeneratorFactory();
-    GeneratorPtr create();
+    std::unique_ptr<CompiledGenerator> create();
 };
 }
 
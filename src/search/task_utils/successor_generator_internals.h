@@ -3,88 +3,198 @@
 
 #include "../operator_id.h"
 
-#include <memory>
-#include <unordered_map>
-#include <vector>
+#include "../algorithms/int_packer.h"
 
-class State;
+#include <cassert>
+#include <utility>
+#include <vector>
 
 namespace successor_generator {
-class GeneratorBase {
-public:
-    virtual ~GeneratorBase() {}
+/*
+  Compiled representation of the successor generator decision tree.
 
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const = 0;
-};
+  All nodes are stored in a single vector<int>. Each node starts with a
+  tag identifying its type, followed by its payload. Child nodes are
+  referred to by their offset in the vector.
 
-class GeneratorForkBinary : public GeneratorBase {
-    std::unique_ptr<GeneratorBase> generator1;
-    std::unique_ptr<GeneratorBase> generator2;
-public:
-    GeneratorForkBinary(
-        std::unique_ptr<GeneratorBase> generator1,
-        std::unique_ptr<GeneratorBase> generator2);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
-};
+  - fork:          [FORK, n, child_1, ..., child_n]
+  - single switch: [SWITCH_SINGLE, var_id, value, child]
+  - dense switch:  [SWITCH_DENSE, var_id, domain_size,
+                    child_0, ..., child_{domain_size - 1}]
+                   where child_i is NO_CHILD if no operator requires
+                   var_id = i at this point
+  - sparse switch: [SWITCH_SPARSE, var_id, k,
+                    value_1, child_1, ..., value_k, child_k]
+                   with value_1 < ... < value_k (searched with binary
+                   search, used when a dense switch would be too large)
+  - leaf:          [LEAF, n, op_id_1, ..., op_id_n]
 
-class GeneratorForkMulti : public GeneratorBase {
-    std::vector<std::unique_ptr<GeneratorBase>> children;
-public:
-    GeneratorForkMulti(std::vector<std::unique_ptr<GeneratorBase>> children);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
-};
+  Nodes are evaluated by a loop that dispatches on the tag. Only forks
+  need recursion (for all children but the last one), so there are no
+  virtual calls and no per-node heap objects. Children are visited in
+  the order in which they were added, so the order of the generated
+  operators is deterministic.
 
-class GeneratorSwitchVector : public GeneratorBase {
-    int switch_var_id;
-    std::vector<std::unique_ptr<GeneratorBase>> generator_for_value;
-public:
-    GeneratorSwitchVector(
-        int switch_var_id,
-        std::vector<std::unique_ptr<GeneratorBase>> &&generator_for_value);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
-};
+  The variable values are read through a ValueReader, which allows
+  evaluating the generator on unpacked states (UnpackedValueReader) and
+  directly on packed state buffers (PackedValueReader).
+*/
+class CompiledGenerator {
+    enum NodeType {
+        FORK,
+        SWITCH_SINGLE,
+        SWITCH_DENSE,
+        SWITCH_SPARSE,
+        LEAF
+    };
+
+    std::vector<int> code;
+    int root;
 
-class GeneratorSwitchHash : public GeneratorBase {
-    int switch_var_id;
-    std::unordered_map<int, std::unique_ptr<GeneratorBase>> generator_for_value;
+    int start_node(NodeType type);
+
+    template<typename ValueReader>
+    void generate_from(
+        const ValueReader &get_value, int node,
+        std::vector<OperatorID> &applicable_ops) const;
 public:
-    GeneratorSwitchHash(
-        int switch_var_id,
-        std::unordered_map<int, std::unique_ptr<GeneratorBase>> &&generator_for_value);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    static const int NO_CHILD = -1;
+
+    CompiledGenerator();
+
+    // All add_* methods return the offset of the new node.
+    int add_fork(const std::vector<int> &children);
+    int add_switch_single(int var_id, int value, int child);
+    int add_switch_dense(int var_id, const std::vector<int> &child_for_value);
+    int add_switch_sparse(
+        int var_id, const std::vector<std::pair<int, int>> &values_and_children);
+    int add_leaf(const std::vector<OperatorID> &operators);
+
+    void set_root(int node);
+
+    int get_size_in_bytes() const {
+        return code.size() * sizeof(int);
+    }
+
+    template<typename ValueReader>
+    void generate_applicable_ops(
+        const ValueReader &get_value,
+        std::vector<OperatorID> &applicable_ops) const {
+        assert(root != NO_CHILD);
+        generate_from(get_value, root, applicable_ops);
+    }
 };
 
-class GeneratorSwitchSingle : public GeneratorBase {
-    int switch_var_id;
-    int value;
-    std::unique_ptr<GeneratorBase> generator_for_value;
+template<typename ValueReader>
+void CompiledGenerator::generate_from(
+    const ValueReader &get_value, int node,
+    std::vector<OperatorID> &applicable_ops) const {
+    while (true) {
+        const int *data = &code[node];
+        switch (data[0]) {
+        case FORK: {
+            int num_children = data[1];
+            if (num_children == 0) {
+                return;
+            }
+            const int *children = data + 2;
+            for (int i = 0; i < num_children - 1; ++i) {
+                generate_from(get_value, children[i], applicable_ops);
+            }
+            node = children[num_children - 1];
+            break;
+        }
+        case SWITCH_SINGLE:
+            if (get_value(data[1]) != data[2]) {
+                return;
+            }
+            node = data[3];
+            break;
+        case SWITCH_DENSE: {
+            int value = get_value(data[1]);
+            assert(value < data[2]);
+            node = data[3 + value];
+            if (node == NO_CHILD) {
+                return;
+            }
+            break;
+        }
+        case SWITCH_SPARSE: {
+            int value = get_value(data[1]);
+            const int *entries = data + 3;
+            int low = 0;
+            int high = data[2];
+            while (low < high) {
+                int mid = (low + high) / 2;
+                if (entries[2 * mid] < value) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            if (low == data[2] || entries[2 * low] != value) {
+                return;
+            }
+            node = entries[2 * low + 1];
+            break;
+        }
+        case LEAF: {
+            /*
+              In our experiments (issue688), a loop over push_back was
+              faster here than doing this with a single insert call
+              because the containers are typically very small.
+            */
+            int num_operators = data[1];
+            for (int i = 0; i < num_operators; ++i) {
+                applicable_ops.emplace_back(data[2 + i]);
+            }
+            return;
+        }
+        default:
+            assert(false);
+            return;
+        }
+    }
+}
+
+class UnpackedValueReader {
+    const std::vector<int> &values;
 public:
-    GeneratorSwitchSingle(
-        int switch_var_id, int value,
-        std::unique_ptr<GeneratorBase> generator_for_value);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    explicit UnpackedValueReader(const std::vector<int> &values)
+        : values(values) {
+    }
+
+    int operator()(int var_id) const {
+        return values[var_id];
+    }
 };
 
-class GeneratorLeafVector : public GeneratorBase {
-    std::vector<OperatorID> applicable_operators;
-public:
-    GeneratorLeafVector(std::vector<OperatorID> &&applicable_operators);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+/*
+  Location of a variable in a packed state buffer. This duplicates the
+  information in IntPacker so that reading a value can be inlined into
+  the evaluation loop.
+*/
+struct PackedVariable {
+    int bin_index;
+    int shift;
+    int_packer::IntPacker::Bin read_mask;
 };
 
-class GeneratorLeafSingle : public GeneratorBase {
-    OperatorID applicable_operator;
+class PackedValueReader {
+    const int_packer::IntPacker::Bin *buffer;
+    const std::vector<PackedVariable> &packed_variables;
 public:
-    GeneratorLeafSingle(OperatorID applicable_operator);
-    virtual void generate_applicable_ops(
-        const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
+    PackedValueReader(
+        const int_packer::IntPacker::Bin *buffer,
+        const std::vector<PackedVariable> &packed_variables)
+        : buffer(buffer),
+          packed_variables(packed_variables) {
+    }
+
+    int operator()(int var_id) const {
+        const PackedVariable &var = packed_variables[var_id];
+        return (buffer[var.bin_index] & var.read_mask) >> var.shift;
+    }
 };
 }
 
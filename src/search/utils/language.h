@@ -15,6 +15,18 @@ template<typename T>
 void unused_variable(const T &) {
 }
 
+/*
+  Hint to the CPU that the memory at the given address will be read soon.
+  This is a no-op on compilers that do not support prefetching.
+*/
+inline void prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    unused_variable(address);
+#endif
+}
+
 template<typename T>
 static std::string get_type_name() {
     bool unsupported_compiler = false;
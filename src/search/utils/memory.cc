@@ -2,20 +2,26 @@
 
 #include "../utils/logging.h"
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 
 using namespace std;
 
 namespace utils {
-static char *extra_memory_padding = nullptr;
+/*
+  Threads that run out of memory at the same time all call the handler,
+  so the padding must be released atomically and only once.
+*/
+static atomic<char *> extra_memory_padding(nullptr);
 
 // Save standard out-of-memory handler.
 static void (*standard_out_of_memory_handler)() = nullptr;
 
 void continuing_out_of_memory_handler() {
-    release_extra_memory_padding();
-    utils::g_log << "Failed to allocate memory. Released extra memory padding." << endl;
+    if (release_extra_memory_padding()) {
+        utils::g_log << "Failed to allocate memory. Released extra memory padding." << endl;
+    }
 }
 
 void reserve_extra_memory_padding(int memory_in_mb) {
@@ -24,15 +30,19 @@ void reserve_extra_memory_padding(int memory_in_mb) {
     standard_out_of_memory_handler = set_new_handler(continuing_out_of_memory_handler);
 }
 
-void release_extra_memory_padding() {
-    assert(extra_memory_padding);
-    delete[] extra_memory_padding;
-    extra_memory_padding = nullptr;
+bool release_extra_memory_padding() {
+    char *padding = extra_memory_padding.exchange(nullptr);
+    if (!padding) {
+        // Another thread has released the padding already.
+        return false;
+    }
+    delete[] padding;
     assert(standard_out_of_memory_handler);
     set_new_handler(standard_out_of_memory_handler);
+    return true;
 }
 
 bool extra_memory_padding_is_reserved() {
-    return extra_memory_padding;
+    return extra_memory_padding.load() != nullptr;
 }
 }
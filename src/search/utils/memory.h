@@ -23,10 +23,12 @@ std::unique_ptr<T> make_unique_ptr(Args && ... args) {
   best.
 
   The interface assumes a single user. It is not possible for two parts
-  of the planner to reserve extra memory padding at the same time.
+  of the planner to reserve extra memory padding at the same time. The
+  padding may be released and queried concurrently: only the first
+  release frees the memory and returns true.
 */
 extern void reserve_extra_memory_padding(int memory_in_mb);
-extern void release_extra_memory_padding();
+extern bool release_extra_memory_padding();
 extern bool extra_memory_padding_is_reserved();
 }
 
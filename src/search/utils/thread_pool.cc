@@ -0,0 +1,94 @@
+#include "thread_pool.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+ThreadPool::ThreadPool(int num_threads)
+    : current_function(nullptr),
+      num_tasks(0),
+      next_task(0),
+      num_workers_finished(0),
+      generation(0),
+      shutting_down(false) {
+    assert(num_threads >= 1);
+    workers.reserve(num_threads - 1);
+    for (int i = 0; i < num_threads - 1; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        shutting_down = true;
+    }
+    work_available.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run_tasks(const function<void(int)> &task_function, int tasks) {
+    while (true) {
+        int task = next_task.fetch_add(1);
+        if (task >= tasks) {
+            return;
+        }
+        task_function(task);
+    }
+}
+
+void ThreadPool::work() {
+    long long last_generation = 0;
+    unique_lock<mutex> lock(pool_mutex);
+    while (true) {
+        work_available.wait(lock, [&]() {
+                                return shutting_down || generation != last_generation;
+                            });
+        if (shutting_down) {
+            return;
+        }
+        last_generation = generation;
+        const function<void(int)> &task_function = *current_function;
+        int tasks = num_tasks;
+        lock.unlock();
+        run_tasks(task_function, tasks);
+        lock.lock();
+        /*
+          Every worker takes part in every generation. This guarantees
+          that no worker still refers to the function of a previous
+          generation when the next one starts.
+        */
+        ++num_workers_finished;
+        if (num_workers_finished == static_cast<int>(workers.size())) {
+            work_finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(int tasks, const function<void(int)> &task_function) {
+    if (workers.empty() || tasks <= 1) {
+        for (int task = 0; task < tasks; ++task) {
+            task_function(task);
+        }
+        return;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        current_function = &task_function;
+        num_tasks = tasks;
+        next_task = 0;
+        num_workers_finished = 0;
+        ++generation;
+    }
+    work_available.notify_all();
+    run_tasks(task_function, tasks);
+    unique_lock<mutex> lock(pool_mutex);
+    work_finished.wait(lock, [&]() {
+                           return num_workers_finished == static_cast<int>(workers.size());
+                       });
+    current_function = nullptr;
+}
+}
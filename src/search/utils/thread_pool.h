@@ -0,0 +1,56 @@
+#ifndef UTILS_THREAD_POOL_H
+#define UTILS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Fixed-size pool of worker threads for data-parallel loops.
+
+  parallel_for(n, f) calls f(i) for all i in {0, ..., n - 1}, distributing
+  the calls over the worker threads and the calling thread, and returns
+  once all calls have finished. The order in which the calls happen is
+  unspecified, so callers that need deterministic results should write
+  the result of f(i) to slot i of a preallocated container and process
+  the results sequentially afterwards.
+
+  A pool with num_threads = 1 creates no worker threads and runs all
+  calls in the calling thread. The pool is not reentrant: f must not call
+  parallel_for on the same pool.
+*/
+class ThreadPool {
+    std::vector<std::thread> workers;
+
+    std::mutex pool_mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    const std::function<void(int)> *current_function;
+    int num_tasks;
+    std::atomic<int> next_task;
+    int num_workers_finished;
+    long long generation;
+    bool shutting_down;
+
+    void run_tasks(const std::function<void(int)> &task_function, int tasks);
+    void work();
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const {
+        return workers.size() + 1;
+    }
+
+    void parallel_for(int tasks, const std::function<void(int)> &task_function);
+};
+}
+
+#endif